@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <filesystem>
+
+#include "blobCache.h"
+
+namespace fs = std::filesystem;
+
+struct entryHeader {
+    char     magic[4];          // "WBLB"
+    uint32_t version;
+    uint64_t keySize, valueSize;
+    uint64_t checksum;          // FNV-1a 64 of key, then value
+};
+static const char entryMagic[4] = { 'W', 'B', 'L', 'B' };
+
+static uint64_t fnv1a(const void *data, size_t size, uint64_t h = 0xcbf29ce484222325ull)
+{
+    const uint8_t *p = (const uint8_t *) data;
+    for(size_t i = 0; i < size; i++) h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+bool blobCache::open(const char *dir)
+{
+    path.clear();
+    if(!dir || !*dir) return false;
+
+    std::error_code ec;
+    const fs::path versioned = fs::path(dir) / ("v" + std::to_string(version));
+    fs::create_directories(versioned, ec);
+    if(ec) { printf("blob cache: can't create %s (%s)\n", versioned.string().c_str(), ec.message().c_str()); return false; }
+    path = versioned.string() + "/";
+    return true;
+}
+
+std::string blobCache::entryPath(const void *key, size_t keySize) const
+{
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long) fnv1a(key, keySize));
+    return path + name + ".bin";
+}
+
+size_t blobCache::load(const void *key, size_t keySize, void *value, size_t valueSize)
+{
+    if(!isOpen()) return 0;
+
+    FILE *f = fopen(entryPath(key, keySize).c_str(), "rb");
+    if(!f) { misses++; return 0; }
+
+    // entry read whole and checked on every call (size query and copy)
+    entryHeader hdr;
+    std::vector<uint8_t> data;
+    bool valid = fread(&hdr, sizeof(hdr), 1, f) == 1 && !memcmp(hdr.magic, entryMagic, 4) && hdr.version == version &&
+                 hdr.keySize == keySize && hdr.valueSize < (uint64_t(1) << 32);
+    if(valid) {
+        data.resize(size_t(hdr.keySize + hdr.valueSize));
+        valid = fread(data.data(), 1, data.size(), f) == data.size() && !memcmp(data.data(), key, keySize) &&
+                fnv1a(data.data(), data.size()) == hdr.checksum;
+    }
+    fclose(f);
+    if(!valid) { rejected++; misses++; return 0; }      // rewritten by next store()
+
+    const size_t size = size_t(hdr.valueSize);
+    if(!value || valueSize < size) return size;
+    memcpy(value, data.data() + keySize, size);
+    hits++;
+    return size;
+}
+
+void blobCache::store(const void *key, size_t keySize, const void *value, size_t valueSize)
+{
+    if(!isOpen()) return;
+
+    entryHeader hdr;
+    memcpy(hdr.magic, entryMagic, 4);
+    hdr.version   = version;
+    hdr.keySize   = keySize;
+    hdr.valueSize = valueSize;
+    hdr.checksum  = fnv1a(value, valueSize, fnv1a(key, keySize));
+
+    // unique temporary name (threads, processes sharing the directory), then rename: atomic replace
+    const std::string target = entryPath(key, keySize);
+    const std::string tmp    = target + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffffff) +
+                              "." + std::to_string(tmpCounter++) + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if(!f) return;
+    const bool written = fwrite(&hdr, sizeof(hdr), 1, f) == 1 && fwrite(key, 1, keySize, f) == keySize &&
+                         fwrite(value, 1, valueSize, f) == valueSize;
+    const bool closed  = fclose(f) == 0;
+
+    std::error_code ec;
+    if(written && closed) fs::rename(tmp, target, ec);
+    if(!written || !closed || ec) { fs::remove(tmp, ec); return; }
+    stores++;
+}
+
+#if !defined(__EMSCRIPTEN__)
+void blobCache::attach(wgpu::DeviceDescriptor &deviceDesc, const std::string &isolationKey)
+{
+    if(!isOpen()) return;
+    isolation = isolationKey;
+    cacheDesc.isolationKey      = { isolation.c_str(), isolation.size() };
+    cacheDesc.loadDataFunction  = [](const void *key, size_t keySize, void *value, size_t valueSize, void *userdata) {
+        return ((blobCache *) userdata)->load(key, keySize, value, valueSize);
+    };
+    cacheDesc.storeDataFunction = [](const void *key, size_t keySize, const void *value, size_t valueSize, void *userdata) {
+        ((blobCache *) userdata)->store(key, keySize, value, valueSize);
+    };
+    cacheDesc.functionUserdata  = this;
+    cacheDesc.nextInChain       = deviceDesc.nextInChain;
+    deviceDesc.nextInChain      = &cacheDesc;
+}
+#endif
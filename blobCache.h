@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  On-disk blob cache for DAWN (DawnCacheDeviceDescriptor): compiled shaders
+//  and backend pipelines survive restarts, cold start compiles them only once
+//   - one file per key in dir/v<version>: header + key + value, FNV-1a 64
+//     checksum of key and value, the key is compared (no hash collisions)
+//   - atomic writes: temporary file renamed to its final name, readers see
+//     a complete entry or none; corrupted / other version entries are misses
+//   - load() / store() can be called by DAWN from any thread
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <string>
+
+#include "wgpuUtils.h"
+
+class blobCache {
+public:
+    static constexpr uint32_t version = 1;      // entry format: bump it to drop every entry
+
+    struct stats {
+        uint64_t hits, misses, stores, rejected;    // rejected: corrupted / mismatched entries
+    };
+
+    // dir created if missing: false if it can't be used (cache disabled)
+    bool open(const char *dir);
+    bool isOpen() const { return !path.empty(); }
+
+    // DAWN hooks: load() with value == nullptr (or smaller valueSize) returns the size of the entry, 0: miss
+    size_t load(const void *key, size_t keySize, void *value, size_t valueSize);
+    void   store(const void *key, size_t keySize, const void *value, size_t valueSize);
+
+#if !defined(__EMSCRIPTEN__)
+    // chain the hooks to device creation: isolationKey keeps adapters / drivers apart
+    void attach(wgpu::DeviceDescriptor &deviceDesc, const std::string &isolationKey);
+#endif
+
+    stats counters() const { return { hits, misses, stores, rejected }; }
+
+private:
+    std::string entryPath(const void *key, size_t keySize) const;
+
+    std::string path;                           // dir/v<version>/, empty: closed
+#if !defined(__EMSCRIPTEN__)
+    wgpu::DawnCacheDeviceDescriptor cacheDesc;
+    std::string isolation;
+#endif
+    std::atomic<uint64_t> hits { 0 }, misses { 0 }, stores { 0 }, rejected { 0 };
+    std::atomic<uint32_t> tmpCounter { 0 };
+};
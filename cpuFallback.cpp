@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <thread>
+
+#include "cpuFallback.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#endif
+
+void cpuFallback::init(unsigned threads, mandelCPU::kernel k)
+{
+    if(!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    pool   = std::make_unique<tilePool>(std::min(threads, maxThreads));
+    kernel = (k == mandelCPU::kernel::Auto || !mandelCPU::isSupported(k)) ? mandelCPU::bestKernel() : k;
+}
+
+mandelCPU::stats cpuFallback::render(const mandelCPU::params &p, uint32_t tileSize)
+{
+    if(!pool) init();
+    w = uint32_t(p.wSizeX); h = uint32_t(p.wSizeY);
+    const mandelCPU::stats s = mandelCPU::renderTiled(*pool, kernel, p, iter, tileSize);
+    rgba.resize(size_t(w) * h * 4);
+    mandelCPU::colorize(p, iter.data(), iter.size(), rgba.data());
+    return s;
+}
+
+#if defined(__EMSCRIPTEN__)
+// slice(): ImageData doesn't accept views of the shared (pthreads) WASM memory
+EM_JS( void, blitRGBA, (const char *selector, const uint8_t *rgba, int width, int height),
+{
+    const canvas = document.querySelector(UTF8ToString(selector));
+    const ctx = canvas ? canvas.getContext("2d") : null;
+    if (!ctx) return;
+    const pixels = new Uint8ClampedArray(HEAPU8.slice(rgba, rgba + width * height * 4).buffer);
+    ctx.putImageData(new ImageData(pixels, width, height), 0, 0);
+} );
+
+void cpuFallback::blit(const char *canvasSelector) const
+{
+    if(w && h && !rgba.empty()) blitRGBA(canvasSelector, rgba.data(), int(w), int(h));
+}
+#endif
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  CPU renderer when WebGPU is missing (browser without navigator.gpu, no
+//  adapter / device): escape-time kernel of mandelCPU (WASM SIMD128 when built
+//  with -msimd128) on a tilePool, colorize() to RGBA, blit() to the canvas
+//   - Emscripten with -pthread: the pool threads are WebWorkers sharing the
+//     WASM memory, pre-spawned (PTHREAD_POOL_SIZE >= maxThreads), so run()
+//     never waits for a worker to start
+//   - no browser API outside blit(): the same code runs under Node (mandel_cpu)
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <memory>
+
+#include "mandelCPU.h"
+#include "tilePool.h"
+
+class cpuFallback {
+public:
+    static constexpr unsigned maxThreads = 8;       // PTHREAD_POOL_SIZE of the web builds
+
+    // threads 0: hardware_concurrency (navigator.hardwareConcurrency), at most maxThreads
+    void init(unsigned threads = 0, mandelCPU::kernel k = mandelCPU::kernel::Auto);
+    bool isActive() const { return pool != nullptr; }
+
+    // whole p.wSizeX x p.wSizeY view: iterations, then RGBA
+    mandelCPU::stats render(const mandelCPU::params &p, uint32_t tileSize = 64);
+
+    const int32_t *iterations() const { return iter.data(); }
+    const uint8_t *pixels()     const { return rgba.data(); }
+    uint32_t width()  const { return w; }
+    uint32_t height() const { return h; }
+    unsigned threads() const { return pool ? pool->size() : 0; }
+    mandelCPU::kernel usedKernel() const { return kernel; }
+
+#if defined(__EMSCRIPTEN__)
+    // last render() to the canvas (2D context): the canvas must have no WebGPU / WebGL context
+    void blit(const char *canvasSelector) const;
+#endif
+
+private:
+    std::unique_ptr<tilePool> pool;
+    mandelCPU::kernel    kernel = mandelCPU::kernel::Auto;
+    std::vector<int32_t> iter;
+    std::vector<uint8_t> rgba;
+    uint32_t             w = 0, h = 0;
+};
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <algorithm>
+#include <thread>
+#include <functional>
+
+#include "cpuProfiler.h"
+
+void cpuProfiler::record(const char *name, uint64_t begin, uint64_t end, bool isFrame)
+{
+    static thread_local const uint32_t thread = uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffff);
+
+    const uint64_t i = head.fetch_add(1, std::memory_order_relaxed);
+    slot &s = ring[i & (ringSize - 1)];
+    // seqlock writer: invalid, fields, then published (the fence keeps the fields after the invalidation)
+    s.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.name.store(name, std::memory_order_relaxed);
+    s.begin.store(begin, std::memory_order_relaxed);
+    s.end.store(end, std::memory_order_relaxed);
+    s.thread.store(thread, std::memory_order_relaxed);
+    s.seq.store(i + 1, std::memory_order_release);
+
+    if(isFrame) frameMs[frameHead.fetch_add(1, std::memory_order_relaxed) & (frameRingSize - 1)].store(float(double(end - begin) * 1e-6), std::memory_order_relaxed);
+}
+
+bool cpuProfiler::read(uint64_t i, sample &out) const
+{
+    const slot &s = ring[i & (ringSize - 1)];
+    if(s.seq.load(std::memory_order_acquire) != i + 1) return false;
+    out = { s.name.load(std::memory_order_relaxed), s.begin.load(std::memory_order_relaxed),
+            s.end.load(std::memory_order_relaxed), s.thread.load(std::memory_order_relaxed) };
+    // seqlock reader: still the same sample after the copy, otherwise a writer reused the slot meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.seq.load(std::memory_order_relaxed) == i + 1;
+}
+
+bool cpuProfiler::frameTimePercentiles(const float *p, float *ms, int count) const
+{
+    const uint32_t n = std::min(frameHead.load(std::memory_order_relaxed), frameRingSize);
+    if(!n) return false;
+
+    std::vector<float> sorted(n);
+    for(uint32_t i = 0; i < n; i++) sorted[i] = frameMs[i].load(std::memory_order_relaxed);
+    std::sort(sorted.begin(), sorted.end());
+    for(int i = 0; i < count; i++)
+        ms[i] = sorted[std::min(n - 1, uint32_t(p[i] * float(n - 1) + .5f))];
+    return true;
+}
+
+bool cpuProfiler::writeChromeTrace(const char *path, double seconds) const
+{
+    FILE *f = fopen(path, "w");
+    if(!f) { printf("cpuProfiler: can't write %s\n", path); return false; }
+
+    const uint64_t last = head.load(std::memory_order_relaxed);
+    const uint64_t first = last > ringSize ? last - ringSize : 0;
+    const uint64_t t = now(), from = t - std::min(t, uint64_t(seconds * 1e9));
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool comma = false;
+    for(uint64_t i = first; i < last; i++) {
+        sample s;
+        if(!read(i, s) || !s.name || s.end < from) continue;
+        // complete event ("X"), us
+        fprintf(f, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                comma ? "," : "", s.name, s.thread, double(s.begin) * 1e-3, double(s.end - s.begin) * 1e-3);
+        comma = true;
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    printf("cpuProfiler: last %.1f s written in %s\n", seconds, path);
+    return true;
+}
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  CPU timing zones of the frame stages
+//   - zone: scoped timer, from constructor to destructor (or end())
+//   - samples in a lock-free ring (last ringSize zones): writers only reserve a
+//     slot with an atomic increment, never wait
+//   - each slot is published with a sequence number (release / acquire): the
+//     trace writer skips slots being written or overwritten, never a torn sample
+//   - "frame" zones also feed the frame time ring: percentiles for a histogram
+//   - writeChromeTrace(): last seconds as trace_event JSON (chrome://tracing,
+//     https://ui.perfetto.dev)
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+class cpuProfiler {
+public:
+    static constexpr uint32_t ringSize = 1 << 16, frameRingSize = 512;     // power of 2
+
+    struct sample {
+        const char *name;           // static string
+        uint64_t    begin, end;     // ns from profiler creation
+        uint32_t    thread;
+    };
+
+    class zone {
+    public:
+        zone(cpuProfiler &p, const char *name, bool isFrame = false) : profiler(p), name(name), isFrame(isFrame), begin(p.now()) {}
+        ~zone() { end(); }
+        void end() { if(name) profiler.record(name, begin, profiler.now(), isFrame); name = nullptr; }
+    private:
+        cpuProfiler &profiler;
+        const char  *name;
+        bool         isFrame;
+        uint64_t     begin;
+    };
+
+    uint64_t now() const { return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()); }
+    void record(const char *name, uint64_t begin, uint64_t end, bool isFrame = false);
+
+    // frame time (ms) at percentiles p[i] in [0, 1] of last frameRingSize frames, false if none
+    bool frameTimePercentiles(const float *p, float *ms, int count) const;
+    // zones ended in the last seconds as Chrome trace_event JSON
+    bool writeChromeTrace(const char *path, double seconds) const;
+
+private:
+    // sample fields as relaxed atomics: seq = index + 1 of the sample once complete, 0 while written
+    struct slot {
+        std::atomic<uint64_t>     seq { 0 };
+        std::atomic<const char *> name { nullptr };
+        std::atomic<uint64_t>     begin { 0 }, end { 0 };
+        std::atomic<uint32_t>     thread { 0 };
+    };
+    bool read(uint64_t i, sample &s) const;        // false: slot i not (or no longer) holding sample i
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<slot>     ring = std::vector<slot>(ringSize);
+    std::atomic<uint64_t> head { 0 };                // samples written (ever)
+    std::atomic<float>    frameMs[frameRingSize] = {};
+    std::atomic<uint32_t> frameHead { 0 };
+};
+
+// CPU_ZONE(profiler, "name"): zone up to the end of current scope
+#define CPU_ZONE_CAT_(a, b) a##b
+#define CPU_ZONE_VAR_(line) CPU_ZONE_CAT_(cpuZone_, line)
+#define CPU_ZONE(profiler, name) cpuProfiler::zone CPU_ZONE_VAR_(__LINE__) (profiler, name)
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <algorithm>
+
+#include "gpuTimer.h"
+
+void gpuTimer::init(const wgpu::Device &device, int passes)
+{
+    if(!device.HasFeature(wgpu::FeatureName::TimestampQuery)) return;
+    nPasses = std::min(passes, int(maxPasses));
+
+    wgpu::QuerySetDescriptor descQuerySet;
+    descQuerySet.label = "passTimestamps";
+    descQuerySet.type  = wgpu::QueryType::Timestamp;
+    descQuerySet.count = ringSize * maxPasses * 2;
+    querySet = device.CreateQuerySet(&descQuerySet);
+
+    resolveBuffer = createBuffer(device, "timestampResolve", wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc, ringSize * slotStride);
+    for(auto &readback : readbacks) readback.create(device, uint64_t(nPasses) * 2 * sizeof(uint64_t), "timestampReadback");
+    for(int i = 0; i < nPasses; i++) history[i].reserve(historySize);
+}
+
+void gpuTimer::beginFrame()
+{
+    slot = -1;
+    if(!isEnabled()) return;
+    for(int s = 0; s < ringSize; s++)
+        if(readbacks[s].isIdle()) { slot = s; usedPasses[s] = 0; return; }
+}
+
+const computeTimestampWrites *gpuTimer::computeWrites(int pass)
+{
+    if(slot < 0 || pass >= nPasses) return nullptr;
+    usedPasses[slot] |= 1u << pass;
+    cWrites[pass].querySet                  = querySet;
+    cWrites[pass].beginningOfPassWriteIndex = queryIndex(pass);
+    cWrites[pass].endOfPassWriteIndex       = queryIndex(pass) + 1;
+    return &cWrites[pass];
+}
+
+const renderTimestampWrites *gpuTimer::renderWrites(int pass)
+{
+    if(slot < 0 || pass >= nPasses) return nullptr;
+    usedPasses[slot] |= 1u << pass;
+    rWrites[pass].querySet                  = querySet;
+    rWrites[pass].beginningOfPassWriteIndex = queryIndex(pass);
+    rWrites[pass].endOfPassWriteIndex       = queryIndex(pass) + 1;
+    return &rWrites[pass];
+}
+
+void gpuTimer::resolve(const wgpu::CommandEncoder &encoder)
+{
+    if(slot < 0 || !usedPasses[slot]) return;
+    encoder.ResolveQuerySet(querySet, queryIndex(0), uint32_t(nPasses) * 2, resolveBuffer, slot * slotStride);
+    readbacks[slot].copyFrom(encoder, resolveBuffer, slot * slotStride);
+}
+
+void gpuTimer::afterSubmit()
+{
+    for(int s = 0; s < ringSize; s++) {
+        if(readbacks[s].isMapped()) collect(s);
+        readbacks[s].release();         // mapped or failed: free for a next frame
+        readbacks[s].requestMap();      // copied in this frame
+    }
+}
+
+void gpuTimer::collect(int s)
+{
+    const uint64_t *t = (const uint64_t *) readbacks[s].data();
+    for(int i = 0; i < nPasses; i++) {
+        if(!(usedPasses[s] & (1u << i)) || t[i * 2 + 1] < t[i * 2]) continue;
+        const float ms = float(double(t[i * 2 + 1] - t[i * 2]) * 1e-6);     // ns -> ms
+        if(int(history[i].size()) < historySize) history[i].push_back(ms);
+        else history[i][historyPos[i]] = ms;
+        historyPos[i] = (historyPos[i] + 1) % historySize;
+        lastMs[i] = ms; samples[i]++;
+    }
+}
+
+gpuTimer::stats gpuTimer::passStats(int pass) const
+{
+    stats st;
+    if(pass >= nPasses || history[pass].empty()) return st;
+
+    std::vector<float> sorted(history[pass]);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for(float v : sorted) sum += v;
+    st.count = int(sorted.size());
+    st.min   = sorted.front();
+    st.avg   = float(sum / st.count);
+    st.p99   = sorted[std::min(st.count - 1, st.count * 99 / 100)];
+    return st;
+}
@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  GPU time of compute / render passes (timestamp queries)
+//   - every timed pass writes begin / end timestamps (pass timestampWrites)
+//   - resolved in the frame encoder and copied in a ring of asyncReadback: read
+//     some frames later, a frame is not timed when all of them are in flight
+//   - last historySize samples of every pass: min / avg / p99 in ms
+//  Requires TimestampQuery device feature, otherwise isEnabled() is false and
+//  all *Writes() return nullptr (passes are not timed)
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "wgpuUtils.h"
+
+class gpuTimer {
+public:
+    static constexpr int maxPasses = 4, ringSize = 4, historySize = 256;
+
+    struct stats {
+        float min = 0, avg = 0, p99 = 0;    // ms
+        int   count = 0;                    // samples in history
+    };
+
+    void init(const wgpu::Device &device, int passes);
+    bool isEnabled() const { return querySet != nullptr; }
+
+    // every frame: beginFrame(), passes with *Writes(), resolve(encoder), Submit, afterSubmit()
+    void beginFrame();
+    const computeTimestampWrites *computeWrites(int pass);     // nullptr: pass not timed
+    const renderTimestampWrites  *renderWrites(int pass);
+    void resolve(const wgpu::CommandEncoder &encoder);
+    void afterSubmit();
+
+    stats passStats(int pass) const;
+    // most recent sample of a pass (ms) and samples collected so far: a new sample when the count moves
+    float    lastSample(int pass) const { return pass < nPasses ? lastMs[pass] : 0.f; }
+    uint64_t sampleCount(int pass) const { return pass < nPasses ? samples[pass] : 0; }
+
+private:
+    static constexpr uint64_t slotStride = 256;   // ResolveQuerySet destination offset alignment
+
+    uint32_t queryIndex(int pass) const { return uint32_t((slot * maxPasses + pass) * 2); }
+    void collect(int s);
+
+    wgpu::QuerySet         querySet;
+    wgpu::Buffer           resolveBuffer;
+    asyncReadback          readbacks[ringSize];
+    uint32_t               usedPasses[ringSize] = {};  // bit mask of passes timed in the frame of every slot
+    int                    slot = -1;                  // ring slot of current frame, -1: not timed
+    int                    nPasses = 0;
+    computeTimestampWrites cWrites[maxPasses];
+    renderTimestampWrites  rWrites[maxPasses];
+    std::vector<float>     history[maxPasses];         // ms, circular
+    int                    historyPos[maxPasses] = {};
+    float                  lastMs[maxPasses] = {};
+    uint64_t               samples[maxPasses] = {};
+};
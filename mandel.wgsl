@@ -18,8 +18,21 @@ R"(
         iterations  : i32,
         nColors     : i32,
         shift       : f32,
+        interior    : i32,      // interior checks: interiorBulbs | interiorPeriodic bits
     };
     @group(0) @binding(0) var<uniform> sd : shaderData;
+    // cs() only: smooth iteration count (0: inside the set), colored by mandel_color.wgsl
+    @group(0) @binding(1) var iterTex : texture_storage_2d<r32float, write>;
+    // cs() only: per pixel state, to continue iterations when sd.iterations is raised
+    struct pixelState {
+        z  : vec4f,             // z(n): xy (f32), (x hi, x lo, y hi, y lo) in mandel_df64.wgsl
+        n  : i32,               // iterations done (0: restart from z = 0), < 0: escaped at -n
+        zz : f32,               // |z|^2 at escape
+        err: f32,               // zoom reprojection error (mandel_reproject.wgsl)
+    };
+    @group(0) @binding(2) var<storage, read_write> state : array<pixelState>;
+    // false: state is a placeholder (too big for the device limits), every cs() iterates from z = 0
+    override resumable : bool = true;
 
     @vertex fn vs(@builtin(vertex_index) VertexIndex : u32) -> @builtin(position) vec4f
     {
@@ -39,21 +52,133 @@ R"(
         return (rgb - 0.5) * C + hsl.z;
     }
 
-    @fragment fn fs(@builtin(position) position: vec4f) -> @location(0) vec4f
+    struct escape {
+        i  : i32,               // escape iteration, 0: inside the set (limit reached), -1: proven inside
+        zz : f32,               // |z|^2 at escape
+        z  : vec2f,             // last z
+    };
+
+    // pipeline-overridable constants (FragmentState::constants, pipelineVariants.h): the loop is
+    // specialised at pipeline creation, the defaults are z^2 + c with bailout |z| > 4 of every pipeline
+    override escapeRadius : f32  = 4.;
+    override unroll       : i32  = 1;       // iterations per bailout branch, an escaped block is replayed
+    override smoothColor  : bool = false;   // fs(): smooth count instead of the escape iteration
+    override power        : i32  = 2;       // z^power + c
+
+    fn zPow(z: vec2f) -> vec2f
     {
-        let c: vec2f = sd.mTransp - sd.mScale + position.xy / sd.wSize * (sd.mScale * 2.);
-        var z: vec2f = vec2f(0.);
-        var clr: f32 = 0.;
-
-        for (var i: i32 = 1; i < sd.iterations; i = i + 1) {
-            z = vec2f(z.x * z.x - z.y * z.y, 2. * z.x * z.y) + c;
-            if (dot(z, z) > 16.) {
-                clr = f32(i) / f32(sd.nColors);
-                break;
+        if (power == 2) { return vec2f(z.x * z.x - z.y * z.y, 2. * z.x * z.y); }
+        var r = z;
+        for (var k = 1; k < power; k = k + 1) { r = vec2f(r.x * z.x - r.y * z.y, r.x * z.y + r.y * z.x); }
+        return r;
+    }
+
+    // interior pixels run all sd.iterations: skip them when they can be proven inside
+    const interiorBulbs    = 1;     // main cardioid and period-2 bulb, analytic test before the loop
+    const interiorPeriodic = 2;     // periodicity (Brent): orbit back within eps of a saved z
+    const provenInside     = 0x40000000;    // pixelState.n of proven inside pixels: never resumed
+
+    fn inCardioidOrBulb(c: vec2f) -> bool
+    {
+        let x  = c.x - .25;
+        let y2 = c.y * c.y;
+        let q  = x * x + y2;
+        if (q * (q + x) <= .25 * y2) { return true; }
+        return (c.x + 1.) * (c.x + 1.) + y2 <= .0625;
+    }
+
+    // complex units per pixel of the view
+    fn viewStep() -> f32 { return 2. * sd.mScale.y / sd.wSize.y; }
+
+    // iterations first .. sd.iterations-1 starting from z0 = z(first - 1), step: complex units per pixel
+    fn iterateFrom(c: vec2f, z0: vec2f, first: i32, step: f32) -> escape
+    {
+        if (first == 1 && power == 2 && (sd.interior & interiorBulbs) != 0 && inCardioidOrBulb(c)) { return escape(-1, 0., z0); }
+
+        // Brent: z saved every 2^k steps, a cycle of period p is found within 2p steps after the orbit settles
+        let periodic = (sd.interior & interiorPeriodic) != 0;
+        let eps = max(1e-3 * step, 1e-7);     // fraction of pixel, >= f32 resolution around |z| ~ 1
+        var zSaved = z0;
+        var lap = 0;
+        var lapLen = 8;
+
+        let bailout = escapeRadius * escapeRadius;
+        var z: vec2f = z0;
+        var i: i32 = first;
+        // unroll > 1: blocks of unroll iterations with one branch, periodicity tested at block end;
+        // the block where z escapes is discarded and replayed one step at a time below (exact i)
+        if (unroll > 1) {
+            loop {
+                if (i + unroll > sd.iterations) { break; }
+                var zb = z;
+                var escaped = false;
+                for (var u = 0; u < unroll; u = u + 1) { zb = zPow(zb) + c; escaped = escaped || dot(zb, zb) > bailout; }
+                if (escaped) { break; }
+                z = zb;
+                i = i + unroll;
+                if (periodic) {
+                    if (all(abs(z - zSaved) < vec2f(eps))) { return escape(-1, 0., z); }
+                    lap = lap + 1;
+                    if (lap == lapLen) { lap = 0; lapLen = lapLen * 2; zSaved = z; }
+                }
             }
         }
+        for (; i < sd.iterations; i = i + 1) {
+            z = zPow(z) + c;
+            let zz = dot(z, z);
+            if (zz > bailout) { return escape(i, zz, z); }
+            if (periodic) {
+                if (all(abs(z - zSaved) < vec2f(eps))) { return escape(-1, 0., z); }
+                lap = lap + 1;
+                if (lap == lapLen) { lap = 0; lapLen = lapLen * 2; zSaved = z; }
+            }
+        }
+        return escape(0, 0., z);
+    }
+
+    fn escapeTime(c: vec2f) -> escape { return iterateFrom(c, vec2f(0.), 1, viewStep()); }
+    // position: pixel coords, as @builtin(position) of fs() (sub-pixel samples of mandel_aa.wgsl)
+    fn escapeAt(position: vec2f) -> escape { return escapeTime(sd.mTransp - sd.mScale + position / sd.wSize * (sd.mScale * 2.)); }
+
+    // continuous count: i + 1 - log_power(log2|z|), kept > 0 (0 is inside)
+    fn smoothIter(e: escape) -> f32
+    {
+        if (e.i <= 0) { return 0.; }
+        return max(f32(e.i) + 1. - log2(.5 * log2(e.zz)) / log2(f32(power)), 1e-3);
+    }
+
+    @fragment fn fs(@builtin(position) position: vec4f) -> @location(0) vec4f
+    {
+        let c: vec2f = sd.mTransp - sd.mScale + position.xy / sd.wSize * (sd.mScale * 2.);
+        let e = escapeTime(c);
+        let clr: f32 = select(f32(e.i), smoothIter(e), smoothColor) / f32(sd.nColors);
 
         if (clr > 0.0) { return vec4f(hsl2rgb(vec3f(sd.shift + clr, 1., 0.5)), 1.); }
         else           { return vec4f(0.); }
     }
+
+    // iteration only: palette changes (nColors, shift) don't need to run it again
+    // only pixels still bounded continue, from z(n); a lowered limit just re-clamps
+    @compute @workgroup_size(8, 8) fn cs(@builtin(global_invocation_id) id: vec3u)
+    {
+        let size = textureDimensions(iterTex);
+        if (any(id.xy >= size)) { return; }
+        let idx = id.y * size.x + id.x;
+        var s = pixelState();
+        if (resumable) { s = state[idx]; }
+
+        if (s.n >= 0 && s.n + 1 < sd.iterations) {
+            let position = vec2f(id.xy) + .5;       // pixel center, as @builtin(position) of fs()
+            let c: vec2f = sd.mTransp - sd.mScale + position / sd.wSize * (sd.mScale * 2.);
+            let e = iterateFrom(c, s.z.xy, s.n + 1, viewStep());
+            if (e.i > 0)      { s.n = -e.i; s.zz = e.zz; }
+            else if (e.i < 0) { s.n = provenInside; }
+            else              { s.n = sd.iterations - 1; s.z = vec4f(e.z, 0., 0.); }
+            if (resumable) { state[idx] = s; }
+        }
+
+        var mu = 0.;
+        if (s.n < 0 && -s.n < sd.iterations) { mu = smoothIter(escape(-s.n, s.zz, vec2f(0.))); }
+        textureStore(iterTex, id.xy, vec4f(mu, 0., 0., 1.));
+    }
 )"
\ No newline at end of file
@@ -0,0 +1,390 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  N.B. to be bit-comparable between kernels this file MUST be compiled without
+//       FP contraction (no FMA): -ffp-contract=off (GCC/Clang), /fp:precise (MSVC)
+//------------------------------------------------------------------------------
+#include "mandelCPU.h"
+#include "tilePool.h"
+
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+
+// no contraction also when a target forgets the compile option (the kernels must stay bit-comparable)
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MANDEL_CPU_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define MANDEL_TARGET(t)                            // MSVC: intrinsics are always available
+    #else
+        #define MANDEL_TARGET(t) __attribute__((target(t))) // GCC/Clang: per function ISA
+    #endif
+#elif defined(__wasm_simd128__)
+    #define MANDEL_CPU_WASM                                 // -msimd128 (Emscripten)
+    #include <wasm_simd128.h>
+#endif
+
+namespace mandelCPU {
+
+// pixel center -> c : same expression of fs()
+//   c = sd.mTransp - sd.mScale + position.xy / sd.wSize * (sd.mScale * 2.)
+static inline float pixelToC(float transp, float scale, float size, float pos)
+{
+    return (transp - scale) + pos / size * (scale * 2.f);
+}
+
+//------------------------------------------------------------------------------
+// Scalar (reference) kernel
+//------------------------------------------------------------------------------
+static void rectScalar(const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride)
+{
+    for(uint32_t y = 0; y < h; y++, iter += stride) {
+        const float cy = pixelToC(p.mTranspY, p.mScaleY, p.wSizeY, float(y0 + y) + .5f);
+        for(uint32_t x = 0; x < w; x++) {
+            const float cx = pixelToC(p.mTranspX, p.mScaleX, p.wSizeX, float(x0 + x) + .5f);
+            float zx = 0.f, zy = 0.f;
+            int32_t res = 0;
+            for(int32_t i = 1; i < p.iterations; i++) {
+                const float nx = (zx * zx - zy * zy) + cx;
+                const float ny = (2.f * zx * zy)     + cy;
+                zx = nx; zy = ny;
+                if(zx * zx + zy * zy > 16.f) { res = i; break; }
+            }
+            iter[x] = res;
+        }
+    }
+}
+
+#if defined(MANDEL_CPU_X86)
+//------------------------------------------------------------------------------
+// SSE4.2: 4 lanes
+//------------------------------------------------------------------------------
+MANDEL_TARGET("sse4.2")
+static void rectSSE42(const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride)
+{
+    const __m128 laneIdx = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+    const __m128 offX    = _mm_set1_ps(p.mTranspX - p.mScaleX);
+    const __m128 sizeX   = _mm_set1_ps(p.wSizeX);
+    const __m128 scale2X = _mm_set1_ps(p.mScaleX * 2.f);
+    const __m128 two     = _mm_set1_ps(2.f);
+    const __m128 bailout = _mm_set1_ps(16.f);
+    alignas(16) int32_t tail[4];
+
+    for(uint32_t y = 0; y < h; y++, iter += stride) {
+        const __m128 cy = _mm_set1_ps(pixelToC(p.mTranspY, p.mScaleY, p.wSizeY, float(y0 + y) + .5f));
+        for(uint32_t x = 0; x < w; x += 4) {
+            const uint32_t n = std::min(4u, w - x);
+            const __m128 px = _mm_add_ps(_mm_set1_ps(float(x0 + x) + .5f), laneIdx);
+            const __m128 cx = _mm_add_ps(offX, _mm_mul_ps(_mm_div_ps(px, sizeX), scale2X));
+            __m128 active = _mm_cmplt_ps(laneIdx, _mm_set1_ps(float(n)));    // tail lanes start finished
+            __m128 zx = _mm_setzero_ps(), zy = _mm_setzero_ps(), res = _mm_setzero_ps();
+            for(int32_t i = 1; i < p.iterations; i++) {
+                const __m128 nx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(zx, zx), _mm_mul_ps(zy, zy)), cx);
+                const __m128 ny = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(two, zx), zy), cy);
+                zx = nx; zy = ny;
+                const __m128 escaped = _mm_and_ps(active, _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(zx, zx), _mm_mul_ps(zy, zy)), bailout));
+                res    = _mm_blendv_ps(res, _mm_set1_ps(float(i)), escaped);
+                active = _mm_andnot_ps(escaped, active);
+                if(!_mm_movemask_ps(active)) break;                          // all lanes finished
+            }
+            if(n == 4) _mm_storeu_si128((__m128i *) (iter + x), _mm_cvttps_epi32(res));
+            else { _mm_store_si128((__m128i *) tail, _mm_cvttps_epi32(res)); memcpy(iter + x, tail, n * sizeof(int32_t)); }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// AVX2: 8 lanes
+//------------------------------------------------------------------------------
+MANDEL_TARGET("avx2")
+static void rectAVX2(const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride)
+{
+    const __m256 laneIdx = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+    const __m256 offX    = _mm256_set1_ps(p.mTranspX - p.mScaleX);
+    const __m256 sizeX   = _mm256_set1_ps(p.wSizeX);
+    const __m256 scale2X = _mm256_set1_ps(p.mScaleX * 2.f);
+    const __m256 two     = _mm256_set1_ps(2.f);
+    const __m256 bailout = _mm256_set1_ps(16.f);
+    alignas(32) int32_t tail[8];
+
+    for(uint32_t y = 0; y < h; y++, iter += stride) {
+        const __m256 cy = _mm256_set1_ps(pixelToC(p.mTranspY, p.mScaleY, p.wSizeY, float(y0 + y) + .5f));
+        for(uint32_t x = 0; x < w; x += 8) {
+            const uint32_t n = std::min(8u, w - x);
+            const __m256 px = _mm256_add_ps(_mm256_set1_ps(float(x0 + x) + .5f), laneIdx);
+            const __m256 cx = _mm256_add_ps(offX, _mm256_mul_ps(_mm256_div_ps(px, sizeX), scale2X));
+            __m256 active = _mm256_cmp_ps(laneIdx, _mm256_set1_ps(float(n)), _CMP_LT_OQ);
+            __m256 zx = _mm256_setzero_ps(), zy = _mm256_setzero_ps(), res = _mm256_setzero_ps();
+            for(int32_t i = 1; i < p.iterations; i++) {
+                const __m256 nx = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(zx, zx), _mm256_mul_ps(zy, zy)), cx);
+                const __m256 ny = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(two, zx), zy), cy);
+                zx = nx; zy = ny;
+                const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(zx, zx), _mm256_mul_ps(zy, zy));
+                const __m256 escaped = _mm256_and_ps(active, _mm256_cmp_ps(d2, bailout, _CMP_GT_OQ));
+                res    = _mm256_blendv_ps(res, _mm256_set1_ps(float(i)), escaped);
+                active = _mm256_andnot_ps(escaped, active);
+                if(!_mm256_movemask_ps(active)) break;
+            }
+            if(n == 8) _mm256_storeu_si256((__m256i *) (iter + x), _mm256_cvttps_epi32(res));
+            else { _mm256_store_si256((__m256i *) tail, _mm256_cvttps_epi32(res)); memcpy(iter + x, tail, n * sizeof(int32_t)); }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// AVX-512: 16 lanes, native mask registers
+//------------------------------------------------------------------------------
+MANDEL_TARGET("avx512f")
+static void rectAVX512(const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride)
+{
+    const __m512 laneIdx = _mm512_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f);
+    const __m512 offX    = _mm512_set1_ps(p.mTranspX - p.mScaleX);
+    const __m512 sizeX   = _mm512_set1_ps(p.wSizeX);
+    const __m512 scale2X = _mm512_set1_ps(p.mScaleX * 2.f);
+    const __m512 two     = _mm512_set1_ps(2.f);
+    const __m512 bailout = _mm512_set1_ps(16.f);
+
+    for(uint32_t y = 0; y < h; y++, iter += stride) {
+        const __m512 cy = _mm512_set1_ps(pixelToC(p.mTranspY, p.mScaleY, p.wSizeY, float(y0 + y) + .5f));
+        for(uint32_t x = 0; x < w; x += 16) {
+            const uint32_t n = std::min(16u, w - x);
+            const __mmask16 valid = __mmask16((1u << n) - 1u);
+            const __m512 px = _mm512_add_ps(_mm512_set1_ps(float(x0 + x) + .5f), laneIdx);
+            const __m512 cx = _mm512_add_ps(offX, _mm512_mul_ps(_mm512_div_ps(px, sizeX), scale2X));
+            __mmask16 active = valid;
+            __m512 zx = _mm512_setzero_ps(), zy = _mm512_setzero_ps(), res = _mm512_setzero_ps();
+            for(int32_t i = 1; i < p.iterations; i++) {
+                const __m512 nx = _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(zx, zx), _mm512_mul_ps(zy, zy)), cx);
+                const __m512 ny = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(two, zx), zy), cy);
+                zx = nx; zy = ny;
+                const __m512 d2 = _mm512_add_ps(_mm512_mul_ps(zx, zx), _mm512_mul_ps(zy, zy));
+                const __mmask16 escaped = _mm512_mask_cmp_ps_mask(active, d2, bailout, _CMP_GT_OQ);
+                res    = _mm512_mask_blend_ps(escaped, res, _mm512_set1_ps(float(i)));
+                active = __mmask16(active & ~escaped);
+                if(!active) break;
+            }
+            // maskz form: GCC flags the undefined source of _mm512_cvttps_epi32 (-Wmaybe-uninitialized)
+            _mm512_mask_storeu_epi32(iter + x, valid, _mm512_maskz_cvttps_epi32(valid, res));
+        }
+    }
+}
+
+#endif // MANDEL_CPU_X86
+
+#if defined(MANDEL_CPU_WASM)
+//------------------------------------------------------------------------------
+// WASM SIMD128: 4 lanes, same operations of SSE4.2 (iterations kept as int lanes)
+//------------------------------------------------------------------------------
+static void rectWASM128(const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride)
+{
+    const v128_t laneIdx = wasm_f32x4_make(0.f, 1.f, 2.f, 3.f);
+    const v128_t offX    = wasm_f32x4_splat(p.mTranspX - p.mScaleX);
+    const v128_t sizeX   = wasm_f32x4_splat(p.wSizeX);
+    const v128_t scale2X = wasm_f32x4_splat(p.mScaleX * 2.f);
+    const v128_t two     = wasm_f32x4_splat(2.f);
+    const v128_t bailout = wasm_f32x4_splat(16.f);
+    alignas(16) int32_t tail[4];
+
+    for(uint32_t y = 0; y < h; y++, iter += stride) {
+        const v128_t cy = wasm_f32x4_splat(pixelToC(p.mTranspY, p.mScaleY, p.wSizeY, float(y0 + y) + .5f));
+        for(uint32_t x = 0; x < w; x += 4) {
+            const uint32_t n = std::min(4u, w - x);
+            const v128_t px = wasm_f32x4_add(wasm_f32x4_splat(float(x0 + x) + .5f), laneIdx);
+            const v128_t cx = wasm_f32x4_add(offX, wasm_f32x4_mul(wasm_f32x4_div(px, sizeX), scale2X));
+            v128_t active = wasm_f32x4_lt(laneIdx, wasm_f32x4_splat(float(n)));      // tail lanes start finished
+            v128_t zx = wasm_f32x4_splat(0.f), zy = wasm_f32x4_splat(0.f), res = wasm_i32x4_splat(0);
+            for(int32_t i = 1; i < p.iterations; i++) {
+                const v128_t nx = wasm_f32x4_add(wasm_f32x4_sub(wasm_f32x4_mul(zx, zx), wasm_f32x4_mul(zy, zy)), cx);
+                const v128_t ny = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_mul(two, zx), zy), cy);
+                zx = nx; zy = ny;
+                const v128_t d2 = wasm_f32x4_add(wasm_f32x4_mul(zx, zx), wasm_f32x4_mul(zy, zy));
+                const v128_t escaped = wasm_v128_and(active, wasm_f32x4_gt(d2, bailout));
+                res    = wasm_v128_bitselect(wasm_i32x4_splat(i), res, escaped);
+                active = wasm_v128_andnot(active, escaped);                        // active & ~escaped
+                if(!wasm_v128_any_true(active)) break;
+            }
+            if(n == 4) wasm_v128_store(iter + x, res);
+            else { wasm_v128_store(tail, res); memcpy(iter + x, tail, n * sizeof(int32_t)); }
+        }
+    }
+}
+#endif // MANDEL_CPU_WASM
+
+#if defined(MANDEL_CPU_X86)
+//------------------------------------------------------------------------------
+// Runtime CPU dispatch
+//------------------------------------------------------------------------------
+#if defined(_MSC_VER) && !defined(__clang__)
+static bool cpuHas(kernel k)
+{
+    int r[4];
+    __cpuid(r, 0);
+    const int maxLeaf = r[0];
+    __cpuid(r, 1);
+    const bool sse42   = (r[2] & (1 << 20)) != 0;
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool osAVX    = (xcr0 & 0x06) == 0x06;    // XMM + YMM state
+    const bool osAVX512 = (xcr0 & 0xe6) == 0xe6;    // + opmask, ZMM state
+    int r7[4] = {};
+    if(maxLeaf >= 7) __cpuidex(r7, 7, 0);
+    switch(k) {
+        case kernel::SSE42:  return sse42;
+        case kernel::AVX2:   return osAVX && (r7[1] & (1 << 5)) != 0;
+        case kernel::AVX512: return osAVX512 && (r7[1] & (1 << 16)) != 0;
+        default:             return false;
+    }
+}
+#else
+static bool cpuHas(kernel k)
+{
+    __builtin_cpu_init();
+    switch(k) {
+        case kernel::SSE42:  return __builtin_cpu_supports("sse4.2");
+        case kernel::AVX2:   return __builtin_cpu_supports("avx2");
+        case kernel::AVX512: return __builtin_cpu_supports("avx512f");
+        default:             return false;
+    }
+}
+#endif
+#else
+static bool cpuHas(kernel) { return false; }
+#endif // MANDEL_CPU_X86
+
+// SIMD128 is a build option: a module using it doesn't even load on engines without it
+#if defined(MANDEL_CPU_WASM)
+static constexpr bool hasWASM128 = true;
+#else
+static constexpr bool hasWASM128 = false;
+#endif
+
+bool isSupported(kernel k)
+{
+    static const bool has[int(kernel::Count)] = { true, true, cpuHas(kernel::SSE42), cpuHas(kernel::AVX2), cpuHas(kernel::AVX512), hasWASM128 };
+    return k < kernel::Count && has[int(k)];
+}
+
+kernel bestKernel()
+{
+    for(kernel k : { kernel::AVX512, kernel::AVX2, kernel::SSE42, kernel::WASM128 })
+        if(isSupported(k)) return k;
+    return kernel::Scalar;
+}
+
+static const char *kernelNames[int(kernel::Count)] = { "auto", "scalar", "sse4.2", "avx2", "avx512", "wasm-simd128" };
+
+const char *kernelName(kernel k) { return k < kernel::Count ? kernelNames[int(k)] : "unknown"; }
+
+kernel kernelFromName(const char *name)
+{
+    for(int i = 0; i < int(kernel::Count); i++)
+        if(!strcmp(name, kernelNames[i])) return kernel(i);
+    return kernel::Count;   // unknown name: the caller reports it
+}
+
+uint64_t renderRect(kernel k, const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride)
+{
+    if(k == kernel::Auto || !isSupported(k)) k = bestKernel();
+    switch(k) {
+#if defined(MANDEL_CPU_X86)
+        case kernel::SSE42:  rectSSE42 (p, x0, y0, w, h, iter, stride); break;
+        case kernel::AVX2:   rectAVX2  (p, x0, y0, w, h, iter, stride); break;
+        case kernel::AVX512: rectAVX512(p, x0, y0, w, h, iter, stride); break;
+#endif
+#if defined(MANDEL_CPU_WASM)
+        case kernel::WASM128: rectWASM128(p, x0, y0, w, h, iter, stride); break;
+#endif
+        default:             rectScalar(p, x0, y0, w, h, iter, stride); break;
+    }
+
+    // work done: escaped pixels stop at i, interior pixels run the whole loop
+    const uint64_t interior = uint64_t(std::max(p.iterations - 1, 0));
+    uint64_t count = 0;
+    for(uint32_t y = 0; y < h; y++, iter += stride)
+        for(uint32_t x = 0; x < w; x++) count += iter[x] ? uint64_t(iter[x]) : interior;
+    return count;
+}
+
+stats render(kernel k, const params &p, std::vector<int32_t> &iter)
+{
+    const uint32_t w = uint32_t(p.wSizeX), h = uint32_t(p.wSizeY);
+    iter.resize(size_t(w) * h);
+
+    stats s;
+    s.usedKernel = (k == kernel::Auto || !isSupported(k)) ? bestKernel() : k;
+    s.pixels     = uint64_t(w) * h;
+
+    auto start   = std::chrono::steady_clock::now();
+    s.iterations = renderRect(s.usedKernel, p, 0, 0, w, h, iter.data(), w);
+    s.seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return s;
+}
+
+uint64_t renderRectTiled(tilePool &pool, kernel k, const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h,
+                         int32_t *iter, size_t stride, uint32_t tileSize)
+{
+    if(k == kernel::Auto || !isSupported(k)) k = bestKernel();
+    const uint32_t tilesX = (w + tileSize - 1) / tileSize;
+    const uint32_t tilesY = (h + tileSize - 1) / tileSize;
+
+    std::atomic<uint64_t> count { 0 };
+    pool.run(tilesX * tilesY, [&](uint32_t tile, unsigned) {
+        const uint32_t tx = (tile % tilesX) * tileSize, ty = (tile / tilesX) * tileSize;
+        const uint32_t tw = std::min(tileSize, w - tx), th = std::min(tileSize, h - ty);
+        count.fetch_add(renderRect(k, p, x0 + tx, y0 + ty, tw, th, iter + ty * stride + tx, stride), std::memory_order_relaxed);
+    });
+    return count.load();
+}
+
+stats renderTiled(tilePool &pool, kernel k, const params &p, std::vector<int32_t> &iter, uint32_t tileSize)
+{
+    const uint32_t w = uint32_t(p.wSizeX), h = uint32_t(p.wSizeY);
+    iter.resize(size_t(w) * h);
+
+    stats s;
+    s.usedKernel = (k == kernel::Auto || !isSupported(k)) ? bestKernel() : k;
+    s.pixels     = uint64_t(w) * h;
+
+    auto start   = std::chrono::steady_clock::now();
+    s.iterations = renderRectTiled(pool, s.usedKernel, p, 0, 0, w, h, iter.data(), w, tileSize);
+    s.seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return s;
+}
+
+// hsl2rgb() of mandel.wgsl with S = 1, L = .5
+void colorize(const params &p, const int32_t *iter, size_t count, uint8_t *rgba)
+{
+    for(size_t i = 0; i < count; i++, rgba += 4) {
+        if(iter[i] <= 0) { rgba[0] = rgba[1] = rgba[2] = rgba[3] = 0; continue; }
+        const float clr = float(iter[i]) / float(p.nColors);
+        const float hue = p.shift + clr;
+        const float H   = hue - std::floor(hue);
+        const float rgb[3] = { std::fabs(H * 6.f - 3.f) - 1.f, 2.f - std::fabs(H * 6.f - 2.f), 2.f - std::fabs(H * 6.f - 4.f) };
+        for(int c = 0; c < 3; c++)
+            rgba[c] = uint8_t(std::clamp(rgb[c], 0.f, 1.f) * 255.f + .5f);
+        rgba[3] = 255;
+    }
+}
+
+} // namespace mandelCPU
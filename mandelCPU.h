@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  CPU reference implementation of the fs() escape-time loop of mandel.wgsl
+//  Same f32 operations in the same order of the shader (no FMA contraction), so
+//  all kernels (scalar / SSE4.2 / AVX2 / AVX-512 / WASM SIMD128) give bit-identical results
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class tilePool;
+
+namespace mandelCPU {
+
+// Same layout/meaning of shaderData_ (and of shaderData struct in mandel.wgsl)
+struct params {
+    float mScaleX, mScaleY;
+    float mTranspX, mTranspY;
+    float wSizeX, wSizeY;
+    int32_t iterations, nColors;
+    float shift;
+};
+
+// build params from any shaderData_ of the examples
+template <class SD> params fromShaderData(const SD &sd) {
+    return { sd.mScaleX, sd.mScaleY, sd.mTranspX, sd.mTranspY, sd.wSizeX, sd.wSizeY, sd.iterations, sd.nColors, sd.shift };
+}
+
+enum class kernel { Auto, Scalar, SSE42, AVX2, AVX512, WASM128, Count };
+
+struct stats {
+    kernel   usedKernel;
+    uint64_t pixels;
+    uint64_t iterations;        // z = z^2 + c steps performed (escaped: i, interior: iterations-1)
+    double   seconds;
+    double   mPixelsPerSec() const { return seconds > 0 ? double(pixels)     / seconds * 1e-6 : 0; }
+    double   gIterPerSec()   const { return seconds > 0 ? double(iterations) / seconds * 1e-9 : 0; }
+};
+
+bool        isSupported(kernel k);      // runtime CPU check (WASM128: built with -msimd128)
+kernel      bestKernel();               // widest supported kernel
+const char *kernelName(kernel k);
+kernel      kernelFromName(const char *name); // "auto" | "scalar" | "sse4.2" | "avx2" | "avx512" | "wasm-simd128", else Count
+
+// Escape iteration of every pixel in the rect (x0, y0, w, h) of the p.wSizeX x p.wSizeY viewport:
+//   i (same i of fs() loop) for escaped pixels, 0 for interior pixels
+// iter points to (x0, y0) pixel, stride in elements. Returns iterations performed
+uint64_t renderRect(kernel k, const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, int32_t *iter, size_t stride);
+
+// Whole viewport, with timing
+stats render(kernel k, const params &p, std::vector<int32_t> &iter);
+
+// Multicore: rect split in tileSize x tileSize tiles scheduled on the work-stealing pool
+uint64_t renderRectTiled(tilePool &pool, kernel k, const params &p, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h,
+                         int32_t *iter, size_t stride, uint32_t tileSize = 64);
+stats    renderTiled(tilePool &pool, kernel k, const params &p, std::vector<int32_t> &iter, uint32_t tileSize = 64);
+
+// Same colors of fs(): hsl2rgb(shift + i/nColors, 1, .5) or black, RGBA8
+void colorize(const params &p, const int32_t *iter, size_t count, uint8_t *rgba);
+
+} // namespace mandelCPU
@@ -0,0 +1,500 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+#include "mandelCompute.h"
+
+static const char *iterateShader = {
+    #include "mandel.wgsl"
+};
+static const char *iterateShaderDF64 = {
+    #include "mandel_df64.wgsl"
+};
+static const char *colorShader = {
+    #include "mandel_color.wgsl"
+};
+static const char *reprojectShader = {
+    #include "mandel_reproject.wgsl"
+};
+static const char *aaShader = {
+    #include "mandel_aa.wgsl"
+};
+
+static constexpr uint64_t pixelStateSize = 32;  // pixelState in mandel.wgsl: vec4f z, i32 n, f32 zz, f32 err (align 16)
+static constexpr uint64_t aaSampleSize   = 64;  // array<vec4f, 4> in mandel_aa.wgsl: up to 16 smooth counts
+
+void mandelCompute::init(const wgpu::Device &dev, wgpu::TextureFormat format, const wgpu::Buffer &uboBuffer, uint64_t uboBytes, const palette &colors)
+{
+    device  = dev;
+    ubo     = uboBuffer;
+    uboSize = uboBytes;
+    paletteView    = colors.view();
+    paletteSampler = colors.sampler();
+
+    // compute: @binding(0) shaderData, (1) iteration texture (write), (2) pixel state
+    {
+        wgpu::BindGroupLayoutEntry entries[3];
+        for(int i = 0; i < 3; i++) { entries[i].binding = i; entries[i].visibility = wgpu::ShaderStage::Compute; }
+        entries[0].buffer.type                  = wgpu::BufferBindingType::Uniform;
+        entries[0].buffer.minBindingSize        = uboSize;
+        entries[1].storageTexture.access        = wgpu::StorageTextureAccess::WriteOnly;
+        entries[1].storageTexture.format        = wgpu::TextureFormat::R32Float;
+        entries[1].storageTexture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[2].buffer.type                  = wgpu::BufferBindingType::Storage;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 3;
+        bindGroupLayoutDesc.entries = entries;
+        computeLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &computeLayout;
+
+        // one module per precision: cs() and csRefine() (mandel_aa.wgsl uses escapeAt() of the precision)
+        const std::string codeF32 = std::string(iterateShader) + aaShader, codeDF64 = std::string(iterateShaderDF64) + aaShader;
+        modules[f32]  = createShaderModule(device, codeF32.c_str(),  "mandelIterate");
+        modules[df64] = createShaderModule(device, codeDF64.c_str(), "mandelIterateDF64");
+
+        wgpu::ComputePipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.compute.entryPoint = "cs";
+        for(int p = f32; p <= df64; p++) {
+            descPipeline.compute.module = modules[p];
+            pipelines[p] = device.CreateComputePipeline(&descPipeline);
+        }
+        // pixel states over the device limits: cs() without them (override resumable)
+        wgpu::ConstantEntry notResumable;
+        notResumable.key   = "resumable";
+        notResumable.value = 0.;
+        descPipeline.compute.constantCount = 1;
+        descPipeline.compute.constants     = &notResumable;
+        for(int p = f32; p <= df64; p++) {
+            descPipeline.compute.module = modules[p];
+            statelessPipelines[p] = device.CreateComputePipeline(&descPipeline);
+        }
+    }
+
+    // refine: @binding(0) shaderData, (3) iteration texture (read), (4) aaData, (5) slots, (6) samples, (7) counter
+    {
+        wgpu::BindGroupLayoutEntry entries[6];
+        const uint32_t bindings[6] = { 0, 3, 4, 5, 6, 7 };
+        for(int i = 0; i < 6; i++) { entries[i].binding = bindings[i]; entries[i].visibility = wgpu::ShaderStage::Compute; }
+        entries[0].buffer.type           = wgpu::BufferBindingType::Uniform;
+        entries[0].buffer.minBindingSize = uboSize;
+        entries[1].texture.sampleType    = wgpu::TextureSampleType::UnfilterableFloat;
+        entries[1].texture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[2].buffer.type           = wgpu::BufferBindingType::Uniform;
+        for(int i = 3; i < 6; i++) entries[i].buffer.type = wgpu::BufferBindingType::Storage;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 6;
+        bindGroupLayoutDesc.entries = entries;
+        refineLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &refineLayout;
+
+        wgpu::ComputePipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.compute.entryPoint = "csRefine";
+        for(int p = f32; p <= df64; p++) {
+            descPipeline.compute.module = modules[p];
+            refinePipelines[p] = device.CreateComputePipeline(&descPipeline);
+        }
+
+        aaUbo = createBuffer(device, "aaData", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, sizeof(aaData));
+        aaCountReadback.create(device, sizeof(uint32_t), "aaCountReadback");
+    }
+
+    // accumulate: @binding(0) shaderData, (3) iteration texture (read), (8) accumData, (9) history, (10) palette LUT, (11) its sampler
+    {
+        wgpu::BindGroupLayoutEntry entries[6];
+        const uint32_t bindings[6] = { 0, 3, 8, 9, 10, 11 };
+        for(int i = 0; i < 6; i++) { entries[i].binding = bindings[i]; entries[i].visibility = wgpu::ShaderStage::Compute; }
+        entries[0].buffer.type           = wgpu::BufferBindingType::Uniform;
+        entries[0].buffer.minBindingSize = uboSize;
+        entries[1].texture.sampleType    = wgpu::TextureSampleType::UnfilterableFloat;
+        entries[1].texture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[2].buffer.type           = wgpu::BufferBindingType::Uniform;
+        entries[3].buffer.type           = wgpu::BufferBindingType::Storage;
+        entries[4].texture.sampleType    = wgpu::TextureSampleType::Float;
+        entries[4].texture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[5].sampler.type          = wgpu::SamplerBindingType::Filtering;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 6;
+        bindGroupLayoutDesc.entries = entries;
+        accumLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &accumLayout;
+
+        wgpu::ComputePipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.compute.entryPoint = "csAccumulate";
+        for(int p = f32; p <= df64; p++) {
+            descPipeline.compute.module = modules[p];
+            accumPipelines[p] = device.CreateComputePipeline(&descPipeline);
+        }
+
+        accumUbo = createBuffer(device, "accumData", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, sizeof(accumData));
+    }
+
+    // colorize: @binding(0) shaderData, (1) iteration texture (unfilterable, textureLoad), (2) palette LUT, (3) its sampler,
+    // (4) aaData, (5) slots, (6) samples of refined pixels, (7) accumData, (8) history
+    {
+        wgpu::BindGroupLayoutEntry entries[9];
+        for(int i = 0; i < 9; i++) { entries[i].binding = i; entries[i].visibility = wgpu::ShaderStage::Fragment; }
+        entries[0].buffer.type           = wgpu::BufferBindingType::Uniform;
+        entries[0].buffer.minBindingSize = uboSize;
+        entries[1].texture.sampleType    = wgpu::TextureSampleType::UnfilterableFloat;
+        entries[1].texture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[2].texture.sampleType    = wgpu::TextureSampleType::Float;
+        entries[2].texture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[3].sampler.type          = wgpu::SamplerBindingType::Filtering;
+        entries[4].buffer.type           = wgpu::BufferBindingType::Uniform;
+        entries[5].buffer.type           = wgpu::BufferBindingType::ReadOnlyStorage;
+        entries[6].buffer.type           = wgpu::BufferBindingType::ReadOnlyStorage;
+        entries[7].buffer.type           = wgpu::BufferBindingType::Uniform;
+        entries[8].buffer.type           = wgpu::BufferBindingType::ReadOnlyStorage;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 9;
+        bindGroupLayoutDesc.entries = entries;
+        colorLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &colorLayout;
+
+        wgpu::ShaderModule module = createShaderModule(device, colorShader, "mandelColor");
+
+        wgpu::RenderPipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.vertex.module = module;
+        descPipeline.vertex.bufferCount = 0;
+        descPipeline.primitive.topology         = wgpu::PrimitiveTopology::TriangleStrip;
+        descPipeline.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+        descPipeline.primitive.frontFace        = wgpu::FrontFace::CCW;
+        descPipeline.primitive.cullMode         = wgpu::CullMode::None;
+
+        wgpu::ColorTargetState colorTarget;
+        colorTarget.format    = format;
+        colorTarget.writeMask = wgpu::ColorWriteMask::All;
+
+        wgpu::FragmentState fragment;
+        fragment.module = module;
+        fragment.targetCount = 1;
+        fragment.targets = &colorTarget;
+        descPipeline.fragment = &fragment;
+
+        colorPipeline = device.CreateRenderPipeline(&descPipeline);
+    }
+
+    // reproject: @binding(0) reprojectData, (1) source states, (2) destination states
+    {
+        wgpu::BindGroupLayoutEntry entries[3];
+        for(int i = 0; i < 3; i++) { entries[i].binding = i; entries[i].visibility = wgpu::ShaderStage::Compute; }
+        entries[0].buffer.type = wgpu::BufferBindingType::Uniform;
+        entries[1].buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+        entries[2].buffer.type = wgpu::BufferBindingType::Storage;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 3;
+        bindGroupLayoutDesc.entries = entries;
+        reprojectLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &reprojectLayout;
+
+        wgpu::ComputePipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.compute.module = createShaderModule(device, reprojectShader, "mandelReproject");
+        reprojectPipeline = device.CreateComputePipeline(&descPipeline);
+
+        reprojectUbo = createBuffer(device, "reprojectData", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, sizeof(reprojectData));
+    }
+}
+
+void mandelCompute::resize(uint32_t w, uint32_t h)
+{
+    if(!w || !h || (w == size[0] && h == size[1])) return;
+    size[0] = w; size[1] = h;
+
+    wgpu::TextureDescriptor descTexture;
+    descTexture.label         = "iterationTexture";
+    descTexture.usage         = wgpu::TextureUsage::StorageBinding | wgpu::TextureUsage::TextureBinding;
+    descTexture.dimension     = wgpu::TextureDimension::e2D;
+    descTexture.size          = { w, h, 1 };
+    descTexture.format        = wgpu::TextureFormat::R32Float;
+    descTexture.mipLevelCount = 1;
+    descTexture.sampleCount   = 1;
+    iterTexture = device.CreateTexture(&descTexture);
+    iterView    = iterTexture.CreateView();
+    // 32 bytes per pixel (~265 MB at 4K): over maxStorageBufferBindingSize / maxBufferSize the bind group would
+    // not validate, one element placeholders and every compute() iterates from z = 0 (no resume, no reprojection)
+    // reprojection ping-pong doubles it: the pair within maxBufferSize, otherwise one buffer and zoom() restarts
+    const uint64_t stateBytes = uint64_t(w) * h * pixelStateSize;
+    const wgpu::Limits limits = getLimits(device);
+    stateResumable   = stateBytes <= std::min(uint64_t(limits.maxStorageBufferBindingSize), uint64_t(limits.maxBufferSize));
+    stateReprojected = stateResumable && 2 * stateBytes <= uint64_t(limits.maxBufferSize);
+    for(int i = 0; i < 2; i++)
+        stateBuffers[i] = createBuffer(device, "pixelState", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+                                       (i == 0 ? stateResumable : stateReprojected) ? stateBytes : pixelStateSize);
+    current = 0;                // the full size one, also with a single buffer
+    restart = true;
+
+    aaCountBuffer  = createBuffer(device, "aaCount",   wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage, sizeof(uint32_t));
+
+    allocateRefinement();
+    allocateHistory();
+    createBindGroups();
+}
+
+// slots (4 bytes per pixel) and samples only while AA is enabled (placeholders keep the bind groups valid)
+void mandelCompute::allocateRefinement()
+{
+    const uint64_t pixels = aaSamples ? uint64_t(size[0]) * size[1] : 1;
+    // refined pixels: up to 1/8 of the image (edges are a few %, the rest stays single sample)
+    aaCapacity     = std::max(1u, uint32_t(pixels / 8));
+    aaSlotBuffer   = createBuffer(device, "aaSlot",    wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage, pixels * sizeof(uint32_t));
+    aaSampleBuffer = createBuffer(device, "aaSamples", wgpu::BufferUsage::Storage, uint64_t(aaCapacity) * aaSampleSize);
+    refined     = false;
+    lastRefined = 0;
+    // colorize reads the slots only with samples > 0: off at once, also without a compute() (perturbation)
+    const aaData ad = { aaSamples, aaCapacity, aaThreshold, 0 };
+    device.GetQueue().WriteBuffer(aaUbo, 0, &ad, sizeof(aaData));
+}
+
+void mandelCompute::setAntialias(uint32_t samples, float threshold)
+{
+    const bool wasEnabled = aaSamples != 0;
+    aaSamples   = samples >= 16 ? 16 : samples >= 4 ? 4 : 0;
+    aaThreshold = threshold;
+    if(wasEnabled != (aaSamples != 0) && size[0]) { allocateRefinement(); createBindGroups(); }
+}
+
+// 16 bytes per pixel only while accumulation is enabled (a placeholder keeps the bind groups valid)
+void mandelCompute::allocateHistory()
+{
+    const uint64_t bytes = accumLimit ? uint64_t(size[0]) * size[1] * 4 * sizeof(float) : 4 * sizeof(float);
+    historyBuffer = createBuffer(device, "accumHistory", wgpu::BufferUsage::Storage, bytes);
+    resetAccumulation();
+}
+
+void mandelCompute::createBindGroups()
+{
+    wgpu::BindGroupEntry colorEntries[9];
+    colorEntries[0].binding = 0; colorEntries[0].buffer = ubo; colorEntries[0].size = uboSize;
+    colorEntries[1].binding = 1; colorEntries[1].textureView = iterView;
+    colorEntries[2].binding = 2; colorEntries[2].textureView = paletteView;
+    colorEntries[3].binding = 3; colorEntries[3].sampler = paletteSampler;
+    colorEntries[4].binding = 4; colorEntries[4].buffer = aaUbo;          colorEntries[4].size = sizeof(aaData);
+    colorEntries[5].binding = 5; colorEntries[5].buffer = aaSlotBuffer;   colorEntries[5].size = wgpu::kWholeSize;
+    colorEntries[6].binding = 6; colorEntries[6].buffer = aaSampleBuffer; colorEntries[6].size = wgpu::kWholeSize;
+    colorEntries[7].binding = 7; colorEntries[7].buffer = accumUbo;       colorEntries[7].size = sizeof(accumData);
+    colorEntries[8].binding = 8; colorEntries[8].buffer = historyBuffer;  colorEntries[8].size = wgpu::kWholeSize;
+
+    wgpu::BindGroupDescriptor descBindGroup;
+    descBindGroup.layout     = colorLayout;
+    descBindGroup.entryCount = 9;
+    descBindGroup.entries    = colorEntries;
+    colorBindGroup   = device.CreateBindGroup(&descBindGroup);
+
+    wgpu::BindGroupEntry entries[3];
+    entries[0].binding = 0; entries[0].buffer = ubo; entries[0].size = uboSize;
+    entries[1].binding = 1; entries[1].textureView = iterView;
+    entries[2].binding = 2; entries[2].size = wgpu::kWholeSize;
+
+    descBindGroup.entries    = entries;
+    descBindGroup.layout     = computeLayout;
+    descBindGroup.entryCount = 3;
+    for(int i = 0; i < 2; i++) {
+        entries[2].buffer = stateBuffers[i];
+        computeBindGroups[i] = device.CreateBindGroup(&descBindGroup);
+    }
+
+    wgpu::BindGroupEntry refineEntries[6];
+    refineEntries[0].binding = 0; refineEntries[0].buffer = ubo;            refineEntries[0].size = uboSize;
+    refineEntries[1].binding = 3; refineEntries[1].textureView = iterView;
+    refineEntries[2].binding = 4; refineEntries[2].buffer = aaUbo;          refineEntries[2].size = sizeof(aaData);
+    refineEntries[3].binding = 5; refineEntries[3].buffer = aaSlotBuffer;   refineEntries[3].size = wgpu::kWholeSize;
+    refineEntries[4].binding = 6; refineEntries[4].buffer = aaSampleBuffer; refineEntries[4].size = wgpu::kWholeSize;
+    refineEntries[5].binding = 7; refineEntries[5].buffer = aaCountBuffer;  refineEntries[5].size = wgpu::kWholeSize;
+    descBindGroup.layout     = refineLayout;
+    descBindGroup.entryCount = 6;
+    descBindGroup.entries    = refineEntries;
+    refineBindGroup = device.CreateBindGroup(&descBindGroup);
+
+    wgpu::BindGroupEntry accumEntries[6];
+    accumEntries[0].binding = 0;  accumEntries[0].buffer = ubo;           accumEntries[0].size = uboSize;
+    accumEntries[1].binding = 3;  accumEntries[1].textureView = iterView;
+    accumEntries[2].binding = 8;  accumEntries[2].buffer = accumUbo;      accumEntries[2].size = sizeof(accumData);
+    accumEntries[3].binding = 9;  accumEntries[3].buffer = historyBuffer; accumEntries[3].size = wgpu::kWholeSize;
+    accumEntries[4].binding = 10; accumEntries[4].textureView = paletteView;
+    accumEntries[5].binding = 11; accumEntries[5].sampler = paletteSampler;
+    descBindGroup.layout     = accumLayout;
+    descBindGroup.entryCount = 6;
+    descBindGroup.entries    = accumEntries;
+    accumBindGroup = device.CreateBindGroup(&descBindGroup);
+
+    // source i -> destination 1-i
+    wgpu::BindGroupEntry reprojectEntries[3];
+    reprojectEntries[0].binding = 0; reprojectEntries[0].buffer = reprojectUbo; reprojectEntries[0].size = sizeof(reprojectData);
+    reprojectEntries[1].binding = 1; reprojectEntries[1].size = wgpu::kWholeSize;
+    reprojectEntries[2].binding = 2; reprojectEntries[2].size = wgpu::kWholeSize;
+    descBindGroup.layout  = reprojectLayout;
+    descBindGroup.entries = reprojectEntries;
+    for(int i = 0; i < 2; i++) {
+        reprojectEntries[1].buffer = stateBuffers[i];
+        reprojectEntries[2].buffer = stateBuffers[1 - i];
+        reprojectBindGroups[i] = device.CreateBindGroup(&descBindGroup);
+    }
+}
+
+void mandelCompute::zoom(double offX, double offY, float scale)
+{
+    if(restart || !size[0] || !stateResumable) return;
+    if(!stateReprojected) { restart = true; return; }   // single state buffer: states of the old view are stale
+
+    // new view: mScale' = mScale * r, mTransp' = mTransp + mScale' * off * scale (see mandelPerturb::zoom)
+    // old pixel coords of new one: q = p * r + (r * off * scale + 1 - r) * size / 2
+    const double r = 1.0 + double(scale);
+    const double o[2] = { (r * offX * double(scale) + 1. - r) * size[0] * .5,
+                          (r * offY * double(scale) + 1. - r) * size[1] * .5 };
+    // several zooms before a compute(): q = (p * r + o) * ratio + offset
+    for(int i = 0; i < 2; i++) {
+        if(!reprojectPending) { ratio[i] = 1; offset[i] = 0; }
+        offset[i] += o[i] * ratio[i];
+        ratio[i]  *= r;
+    }
+    reprojectPending = true;
+}
+
+void mandelCompute::compute(const wgpu::CommandEncoder &encoder, precision p, const computeTimestampWrites *timestamps)
+{
+    if(!iterTexture) return;
+
+    // n = 0 everywhere: iterate from z = 0, otherwise continue bounded pixels
+    const bool clear = restart || p != statePrecision;
+    if(clear) encoder.ClearBuffer(stateBuffers[current], 0, wgpu::kWholeSize);
+
+    resetAccumulation();    // new iteration data: history restarts from it
+
+    // every pixel single sample until csRefine() takes it again
+    if(refined || aaSamples) encoder.ClearBuffer(aaSlotBuffer, 0, wgpu::kWholeSize);
+    if(aaSamples) {
+        encoder.ClearBuffer(aaCountBuffer, 0, wgpu::kWholeSize);
+        const aaData ad = { aaSamples, aaCapacity, aaThreshold, 0 };
+        device.GetQueue().WriteBuffer(aaUbo, 0, &ad, sizeof(aaData));
+    }
+
+    wgpu::ComputePassDescriptor descPass;
+    descPass.timestampWrites = timestamps;
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&descPass);
+    if(reprojectPending && !clear) {
+        const reprojectData rd = { { float(ratio[0]), float(ratio[1]) }, { float(offset[0]), float(offset[1]) }, { size[0], size[1] } };
+        device.GetQueue().WriteBuffer(reprojectUbo, 0, &rd, sizeof(reprojectData));
+        pass.SetPipeline(reprojectPipeline);
+        pass.SetBindGroup(0, reprojectBindGroups[current], 0, nullptr);
+        pass.DispatchWorkgroups((size[0] + 7) / 8, (size[1] + 7) / 8, 1);
+        current = 1 - current;
+    }
+    restart = reprojectPending = false;
+    statePrecision = p;
+
+    pass.SetPipeline(stateResumable ? pipelines[p] : statelessPipelines[p]);
+    pass.SetBindGroup(0, computeBindGroups[current], 0, nullptr);
+    pass.DispatchWorkgroups((size[0] + 7) / 8, (size[1] + 7) / 8, 1);   // @workgroup_size(8, 8)
+
+    // edges of the whole image (also pixels not iterated now: the samples of the previous compute were cleared)
+    if(aaSamples) {
+        pass.SetPipeline(refinePipelines[p]);
+        pass.SetBindGroup(0, refineBindGroup, 0, nullptr);
+        pass.DispatchWorkgroups((size[0] + 7) / 8, (size[1] + 7) / 8, 1);
+    }
+    pass.End();
+
+    if(aaSamples) aaCountReadback.copyFrom(encoder, aaCountBuffer);
+    else          lastRefined = 0;
+    refined = aaSamples != 0;
+}
+
+void mandelCompute::discardRefinement(const wgpu::CommandEncoder &encoder)
+{
+    resetAccumulation();
+    if(!refined) return;
+    encoder.ClearBuffer(aaSlotBuffer, 0, wgpu::kWholeSize);
+    refined = false;
+    lastRefined = 0;
+}
+
+void mandelCompute::setAccumulation(uint32_t maxSamples)
+{
+    const bool wasEnabled = accumLimit != 0;
+    accumLimit = maxSamples;
+    if(wasEnabled != (accumLimit != 0) && size[0]) { allocateHistory(); createBindGroups(); }
+    else if(accumCount > accumLimit) resetAccumulation();
+}
+
+void mandelCompute::resetAccumulation()
+{
+    if(!accumCount) return;
+    accumCount = 0;
+    const accumData ad = { 0, aaThreshold, { 0, 0 } };
+    device.GetQueue().WriteBuffer(accumUbo, 0, &ad, sizeof(accumData));
+}
+
+bool mandelCompute::accumulate(const wgpu::CommandEncoder &encoder, const computeTimestampWrites *timestamps)
+{
+    if(!accumulationPending()) return false;
+
+    // sample k (k = 0: center, from cs()) at R2 low discrepancy sequence: fills the pixel evenly at any count
+    const uint32_t k = accumCount ? accumCount : 1;
+    accumCount = k + 1;
+    accumData ad = { accumCount, aaThreshold, { 0, 0 } };
+    ad.jitter[0] = float(std::fmod(.5 + k * 0.7548776662466927, 1.));
+    ad.jitter[1] = float(std::fmod(.5 + k * 0.5698402909980532, 1.));
+    device.GetQueue().WriteBuffer(accumUbo, 0, &ad, sizeof(accumData));
+
+    wgpu::ComputePassDescriptor descPass;
+    descPass.timestampWrites = timestamps;
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&descPass);
+    pass.SetPipeline(accumPipelines[statePrecision]);
+    pass.SetBindGroup(0, accumBindGroup, 0, nullptr);
+    pass.DispatchWorkgroups((size[0] + 7) / 8, (size[1] + 7) / 8, 1);
+    pass.End();
+    return true;
+}
+
+void mandelCompute::afterSubmit()
+{
+    if(aaCountReadback.isMapped() && refined) lastRefined = *(const uint32_t *) aaCountReadback.data();
+    aaCountReadback.release();          // mapped or failed: free for next compute()
+    aaCountReadback.requestMap();
+}
+
+void mandelCompute::colorize(const wgpu::RenderPassEncoder &pass)
+{
+    if(!iterTexture) return;
+
+    pass.SetPipeline(colorPipeline);
+    pass.SetBindGroup(0, colorBindGroup, 0, nullptr);
+    pass.Draw(4, 1, 0, 0);
+}
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Iteration and colouring in two passes
+//   - compute: cs() of mandel.wgsl / mandel_df64.wgsl writes the smooth iteration
+//     count of every pixel in an R32Float storage texture (iteration texture)
+//   - colorize: mandel_color.wgsl, one textureLoad per pixel + one palette LUT sample
+//  Palette changes (nColors, shift, gradient) only need colorize(); compute() only when
+//  view or iterations change. mandelPerturb writes the same texture.
+//  Per pixel z(n) / n are kept in a storage buffer: after a change of iterations
+//  only bounded pixels continue, after invalidate() everything restarts.
+//  When that buffer exceeds the device limits (maxStorageBufferBindingSize,
+//  maxBufferSize: 4K windows with default limits) it's not kept: isResumable()
+//  is false and every compute() iterates from z = 0. When only one fits (not
+//  the reprojection pair) iterations resume but zoom() restarts them.
+//  After zoom() the states are reprojected (mandel_reproject.wgsl) and only
+//  pixels with error > half pixel iterate again.
+//  Edge-adaptive AA (setAntialias): after cs(), csRefine() of mandel_aa.wgsl
+//  takes 4 / 16 jittered samples only on pixels whose count differs from a
+//  neighbour, colorize averages their colors. refinedPixels(): edge pixels of
+//  the last compute (read back without stalls).
+//  Temporal accumulation (setAccumulation): while the view is still, every
+//  accumulate() adds one jittered sample per pixel to a color history (only
+//  edge pixels iterate), colorize shows the mean; any change resets it.
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+
+#include "wgpuUtils.h"
+#include "palette.h"
+
+class mandelCompute {
+public:
+    enum precision { f32, df64 };
+
+    // ubo: shaderData_ of the examples, shared by compute and colorize; colors: LUT of colorize (initialized)
+    void init(const wgpu::Device &device, wgpu::TextureFormat format, const wgpu::Buffer &ubo, uint64_t uboSize, const palette &colors);
+    // (re)allocate the iteration texture: surface resize or render scale change (can be smaller than the surface)
+    void resize(uint32_t w, uint32_t h);
+
+    // iteration texture from shaderData (timestamps: gpuTimer writes of the compute pass, optional)
+    void compute(const wgpu::CommandEncoder &encoder, precision p, const computeTimestampWrites *timestamps = nullptr);
+    void invalidate() { restart = true; }                               // view changed: next compute() from z = 0
+    void zoom(double offX, double offY, float scale);                   // same rule of zoom(): reproject at next compute()
+    void colorize(const wgpu::RenderPassEncoder &pass);                 // full screen draw
+    void afterSubmit();                                                 // refined pixels counter readback
+
+    // samples of refined pixels: 0 (off), 4 or 16, threshold: smooth count difference of an edge
+    // (needs a compute() to take effect: refined samples are iteration data)
+    // (slots and samples buffers allocated only while enabled)
+    void setAntialias(uint32_t samples, float threshold = 1.f);
+    uint32_t antialias() const { return aaSamples; }
+    uint32_t refinedPixels() const { return lastRefined; }              // may exceed capacity: only capacity are refined
+    uint32_t refineCapacity() const { return aaCapacity; }
+    bool refinePending() const { return !aaCountReadback.isIdle(); }   // counter not read yet (render on demand)
+    // perturbation wrote the iteration texture: drop refined samples and accumulation of the previous compute()
+    void discardRefinement(const wgpu::CommandEncoder &encoder);
+
+    // temporal accumulation: up to maxSamples colors per pixel, 0: off
+    void setAccumulation(uint32_t maxSamples);
+    uint32_t accumulationLimit()  const { return accumLimit; }
+    uint32_t accumulatedSamples() const { return accumCount; }
+    // the view has been computed and more samples are wanted (render on demand: keep drawing)
+    bool accumulationPending() const { return accumLimit && accumCount < accumLimit && iterTexture && !restart && !reprojectPending; }
+    // one more jittered sample per pixel, after compute() of the same view: false if nothing to do
+    bool accumulate(const wgpu::CommandEncoder &encoder, const computeTimestampWrites *timestamps = nullptr);
+    void resetAccumulation();                                           // shaderData changed: colorize shows iterations again
+
+    const wgpu::TextureView &iterationView() const { return iterView; }
+    // pixel states fit the device limits: iterations resume and zoom() reprojects (otherwise every compute() from z = 0)
+    bool isResumable() const { return stateResumable; }
+    uint32_t width()  const { return size[0]; }
+    uint32_t height() const { return size[1]; }
+
+private:
+    void createBindGroups();
+    void allocateRefinement();
+    void allocateHistory();
+
+    wgpu::Device          device;
+    wgpu::Buffer          ubo;
+    uint64_t              uboSize = 0;
+    wgpu::TextureView     paletteView;           // palette texture is never reallocated: its view is enough
+    wgpu::Sampler         paletteSampler;
+    wgpu::ShaderModule    modules[2];            // [precision]: cs() + csRefine()
+    wgpu::ComputePipeline pipelines[2], refinePipelines[2], accumPipelines[2];     // [precision]
+    wgpu::ComputePipeline statelessPipelines[2];  // [precision]: cs() with resumable = false
+    wgpu::RenderPipeline  colorPipeline;
+    wgpu::BindGroupLayout computeLayout, colorLayout;
+    wgpu::BindGroup       computeBindGroups[2], colorBindGroup;   // [current state buffer]
+    wgpu::Texture         iterTexture;
+    wgpu::TextureView     iterView;
+    wgpu::Buffer          stateBuffers[2];       // pixelState of mandel.wgsl for every pixel, ping-pong for reprojection
+    int                   current = 0;
+    uint32_t              size[2] = { 0, 0 };
+    bool                  restart = true;
+    precision             statePrecision = f32;  // z(n) in stateBuffer is f32 or df64
+    bool                  stateResumable = true; // false: state buffers over the device limits (placeholders)
+    bool                  stateReprojected = true; // false: the pair doesn't fit, stateBuffers[1] is a placeholder
+
+    // reprojection: old frame coords q = p * ratio + offset (pixels)
+    struct reprojectData {
+        float    ratio[2], offset[2];
+        uint32_t size[2];
+    };
+    wgpu::ComputePipeline reprojectPipeline;
+    wgpu::BindGroupLayout reprojectLayout;
+    wgpu::BindGroup       reprojectBindGroups[2];  // [source state buffer]
+    wgpu::Buffer          reprojectUbo;
+    double                ratio[2] = { 1, 1 }, offset[2] = { 0, 0 };
+    bool                  reprojectPending = false;
+
+    // edge-adaptive AA: aaData of mandel_aa.wgsl
+    struct aaData {
+        uint32_t samples, capacity;
+        float    threshold;
+        uint32_t pad;
+    };
+    wgpu::BindGroupLayout refineLayout;
+    wgpu::BindGroup       refineBindGroup;
+    wgpu::Buffer          aaUbo, aaSlotBuffer, aaSampleBuffer, aaCountBuffer;
+    asyncReadback         aaCountReadback;
+    uint32_t              aaSamples = 0, aaCapacity = 0, lastRefined = 0;
+    float                 aaThreshold = 1.f;
+    bool                  refined = false;       // aaSlotBuffer has slots of last compute()
+
+    // temporal accumulation: accumData of mandel_aa.wgsl
+    struct accumData {
+        uint32_t count;
+        float    threshold;
+        float    jitter[2];
+    };
+    wgpu::BindGroupLayout accumLayout;
+    wgpu::BindGroup       accumBindGroup;
+    wgpu::Buffer          accumUbo, historyBuffer;  // history: vec4f per pixel (only while enabled)
+    uint32_t              accumLimit = 0, accumCount = 0;
+};
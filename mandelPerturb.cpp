@@ -0,0 +1,346 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include "mandelPerturb.h"
+
+#include <cmath>
+#include <algorithm>
+
+static const char *perturbShader = {
+    #include "mandel_perturb.wgsl"
+};
+
+int computeReferenceOrbit(const mpFixed &cx, const mpFixed &cy, int maxIter, std::vector<float> &orbit)
+{
+    orbit.resize(size_t(std::max(maxIter, 1)) * 2);
+    mpFixed zx(cx.size()), zy(cx.size());
+    orbit[0] = orbit[1] = 0.f;
+    int len = 1;
+    for(; len < maxIter; len++) {
+        mpFixed x2 = zx * zx, y2 = zy * zy, xy = zx * zy;
+        zx = x2 - y2 + cx;
+        zy = xy.mul2() + cy;
+        const double x = zx.toDouble(), y = zy.toDouble();
+        orbit[size_t(len) * 2]     = float(x);
+        orbit[size_t(len) * 2 + 1] = float(y);
+        if(x * x + y * y > 16.) { len++; break; }    // keep the escaped element: pixels near it escape too
+    }
+    return len;
+}
+
+//------------------------------------------------------------------------------
+// BLA
+//------------------------------------------------------------------------------
+namespace {
+// complex mantissa * 2^e: A grows up to |2Z|^(2^k), far beyond double range
+struct cExp {
+    double  x = 0, y = 0;
+    int32_t e = 0;
+
+    cExp() = default;
+    cExp(double re, double im, int32_t exp2 = 0) : x(re), y(im), e(exp2) { normalize(); }
+
+    void normalize() {
+        int ex; std::frexp(std::max(std::fabs(x), std::fabs(y)), &ex);
+        if(x == 0 && y == 0) { e = 0; return; }
+        x = std::ldexp(x, -ex); y = std::ldexp(y, -ex); e += ex;
+    }
+    bool isZero() const { return x == 0 && y == 0; }
+    expDouble abs() const { return expDouble(std::hypot(x, y), e); }
+
+    cExp operator*(const cExp &o) const { return cExp(x * o.x - y * o.y, x * o.y + y * o.x, e + o.e); }
+    cExp operator+(const cExp &o) const {
+        if(isZero()) return o;
+        if(o.isZero()) return *this;
+        const int32_t m = std::max(e, o.e);
+        return cExp(std::ldexp(x, e - m) + std::ldexp(o.x, o.e - m), std::ldexp(y, e - m) + std::ldexp(o.y, o.e - m), m);
+    }
+};
+
+struct blaStep { cExp a, b; expDouble r; };
+
+// x then y: A = Ay Ax, B = Ay Bx + By, R = min(Rx, (Ry - |Bx| dcMax) / |Ax|)
+blaStep merge(const blaStep &x, const blaStep &y, const expDouble &dcMax)
+{
+    blaStep z;
+    z.a = y.a * x.a;
+    z.b = y.a * x.b + y.b;
+    const expDouble t = x.b.abs() * dcMax, ax = x.a.abs();
+    expDouble ry;
+    if(t < y.r && ax.m != 0) {
+        const double k = 1. - std::ldexp(t.m / y.r.m, t.e - y.r.e);
+        ry = expDouble(y.r.m * k / ax.m, y.r.e - ax.e);
+    }
+    z.r = ry < x.r ? ry : x.r;
+    return z;
+}
+
+blaEntry toEntry(const blaStep &s)
+{
+    blaEntry b;
+    b.ax = float(s.a.x); b.ay = float(s.a.y); b.ae = s.a.e;
+    b.bx = float(s.b.x); b.by = float(s.b.y); b.be = s.b.e;
+    b.logR = s.r.m > 0 ? float(std::log2(s.r.m) + double(s.r.e)) : -1e30f;
+    b.pad = 0;
+    return b;
+}
+}
+
+int buildBLA(const std::vector<float> &orbit, int len, expDouble dcMax, int epsilonLog2,
+             std::vector<blaEntry> &table, int32_t levelOffset[blaMaxLevels])
+{
+    table.clear();
+    const int count0 = len - 2;      // steps n -> n+1 for n = 1 .. len-2
+    if(count0 < 2) return 0;
+
+    // level 0: dz(n+1) = 2 Z(n) dz(n) + dc, dropped dz^2 small if |dz| < eps |2 Z(n)|
+    std::vector<blaStep> level(static_cast<size_t>(count0)), next;
+    for(int j = 0; j < count0; j++) {
+        const size_t n = size_t(j + 1);
+        blaStep &s = level[size_t(j)];
+        s.a = cExp(2. * orbit[n * 2], 2. * orbit[n * 2 + 1]);
+        s.b = cExp(1., 0.);
+        s.r = s.a.abs() * expDouble(1., epsilonLog2);
+    }
+
+    int levels = 0;
+    for(; levels < blaMaxLevels && !level.empty(); levels++) {
+        levelOffset[levels] = int32_t(table.size());
+        for(const blaStep &s : level) table.push_back(toEntry(s));
+
+        next.resize(level.size() / 2);
+        for(size_t j = 0; j < next.size(); j++) next[j] = merge(level[j * 2], level[j * 2 + 1], dcMax);
+        level.swap(next);
+    }
+    return levels;
+}
+
+//------------------------------------------------------------------------------
+// View
+//------------------------------------------------------------------------------
+void mandelPerturb::setView(double centerX, double centerY, double scaleX, double scaleY, uint32_t w, uint32_t h)
+{
+    sx = expDouble(scaleX); sy = expDouble(scaleY);
+    wSize[0] = w; wSize[1] = h;
+    updatePrecision();
+    cx.set(centerX, 0); cy.set(centerY, 0);
+    viewChanged = true;
+}
+
+void mandelPerturb::zoom(double offX, double offY, float scale)
+{
+    sx = sx * (1.0 + double(scale));
+    sy = sy * (1.0 + double(scale));
+    updatePrecision();
+
+    mpFixed d(cx.size());
+    d.set(sx * (offX * double(scale))); cx += d;
+    d.set(sy * (offY * double(scale))); cy += d;
+    viewChanged = true;
+}
+
+void mandelPerturb::resize(uint32_t w, uint32_t h)
+{
+    sx = sx * (double(w) / double(wSize[0]));
+    sy = sy * (double(h) / double(wSize[1]));
+    wSize[0] = w; wSize[1] = h;
+    viewChanged = true;
+}
+
+void mandelPerturb::setGrid(uint32_t w, uint32_t h)
+{
+    if(w == wSize[0] && h == wSize[1]) return;
+    wSize[0] = w; wSize[1] = h;
+    gridChanged = true;
+}
+
+void mandelPerturb::updatePrecision()
+{
+    // resolve the pixel size: half size / (max window size)
+    const int limbs = mpFixed::limbsFor(std::min(sx.log2(), sy.log2()) - 16);
+    if(limbs > cx.size()) { cx.setPrecision(limbs); cy.setPrecision(limbs); }
+}
+
+bool mandelPerturb::belowResolution(int mantissaBits) const
+{
+    // coords resolve |c| * 2^(1-mantissaBits): pixels smaller than few ulps become blocks
+    const expDouble pixel = sy * (2. / double(wSize[1]));
+    const double c = std::max({ std::fabs(centerX()), std::fabs(centerY()), .5 });
+    return pixel < expDouble(c, 3 - mantissaBits);
+}
+
+//------------------------------------------------------------------------------
+// GPU
+//------------------------------------------------------------------------------
+void mandelPerturb::init(const wgpu::Device &dev)
+{
+    device = dev;
+    wgpu::ShaderModule module = createShaderModule(device, perturbShader, "mandelPerturb");
+
+    // @binding(0) uniform, (1) orbit, (2) glitchMask, (3) glitch counter, (4) BLA table, (5) iteration texture
+    wgpu::BindGroupLayoutEntry entries[6];
+    for(int i = 0; i < 6; i++) { entries[i].binding = i; entries[i].visibility = wgpu::ShaderStage::Compute; }
+    entries[0].buffer.type           = wgpu::BufferBindingType::Uniform;
+    entries[0].buffer.minBindingSize = sizeof(uniformData);
+    entries[1].buffer.type           = wgpu::BufferBindingType::ReadOnlyStorage;
+    entries[2].buffer.type           = wgpu::BufferBindingType::Storage;
+    entries[3].buffer.type           = wgpu::BufferBindingType::Storage;
+    entries[4].buffer.type           = wgpu::BufferBindingType::ReadOnlyStorage;
+    entries[5].storageTexture.access        = wgpu::StorageTextureAccess::WriteOnly;
+    entries[5].storageTexture.format        = wgpu::TextureFormat::R32Float;
+    entries[5].storageTexture.viewDimension = wgpu::TextureViewDimension::e2D;
+
+    wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+    bindGroupLayoutDesc.entryCount = 6;
+    bindGroupLayoutDesc.entries = entries;
+    bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+    wgpu::PipelineLayoutDescriptor layoutDesc;
+    layoutDesc.bindGroupLayoutCount = 1;
+    layoutDesc.bindGroupLayouts = &bindGroupLayout;
+
+    wgpu::ComputePipelineDescriptor descPipeline;
+    descPipeline.layout         = device.CreatePipelineLayout(&layoutDesc);
+    descPipeline.compute.module = module;
+    pipeline = device.CreateComputePipeline(&descPipeline);
+
+    ubo          = createBuffer(device, "perturbData", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, sizeof(uniformData));
+    glitchBuffer = createBuffer(device, "glitchData",  wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage, 2 * sizeof(uint32_t));
+    glitchReadback.create(device, 2 * sizeof(uint32_t), "glitchReadback");
+}
+
+void mandelPerturb::uploadOrbit(int ref, const mpFixed &rx, const mpFixed &ry)
+{
+    const int len = computeReferenceOrbit(rx, ry, uniforms.iterations, orbitData);
+    device.GetQueue().WriteBuffer(orbitBuffer, uint64_t(ref ? orbitCapacity : 0) * 2 * sizeof(float), orbitData.data(), size_t(len) * 2 * sizeof(float));
+    if(ref) { uniforms.refLen1 = len; return; }
+    uniforms.refLen0 = len;
+
+    // BLA only for the primary reference: secondary one renders few pixels
+    uniforms.blaLevels = uniforms.blaCount0 = 0;
+    blaBuiltWith = useBLA ? blaToleranceLog2 : 0;
+    if(!useBLA) return;
+    const expDouble dcMax = (sx < sy ? sy : sx) * 1.4142135623730951;   // view corner from the center
+    uniforms.blaLevels = buildBLA(orbitData, len, dcMax, blaToleranceLog2, blaTable, uniforms.blaOffset);
+    uniforms.blaCount0 = std::max(len - 2, 0);
+    if(!blaTable.empty()) device.GetQueue().WriteBuffer(blaBuffer, 0, blaTable.data(), blaTable.size() * sizeof(blaEntry));
+}
+
+bool mandelPerturb::needsUpdate() const
+{
+    // copiedEpoch: glitch counters of current view not yet copied (readback was busy)
+    return viewChanged || gridChanged || secondaryChanged || copiedEpoch != viewEpoch || (useBLA ? blaToleranceLog2 : 0) != blaBuiltWith;
+}
+
+void mandelPerturb::update(const wgpu::CommandEncoder &encoder, int32_t iterations, const wgpu::TextureView &iterationView)
+{
+    bool rebind = !bindGroup || boundView != iterationView.Get();
+
+    if(uint32_t(iterations) > orbitCapacity) {     // room for primary + secondary orbits
+        orbitCapacity = uint32_t(iterations);
+        orbitBuffer = createBuffer(device, "referenceOrbits", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage, uint64_t(orbitCapacity) * 2 * 2 * sizeof(float));
+        // all BLA levels: < 2 * orbit length
+        blaBuffer   = createBuffer(device, "blaTable", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage, uint64_t(orbitCapacity) * 2 * sizeof(blaEntry));
+        viewChanged = rebind = true;
+    }
+    if(maskSize[0] != wSize[0] || maskSize[1] != wSize[1]) {
+        maskSize[0] = wSize[0]; maskSize[1] = wSize[1];
+        glitchMaskBuffer = createBuffer(device, "glitchMask", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage, uint64_t(wSize[0]) * wSize[1] * sizeof(uint32_t));
+        gridChanged = rebind = true;
+    }
+    if(iterations != uniforms.iterations) viewChanged = true;
+    if((useBLA ? blaToleranceLog2 : 0) != blaBuiltWith) viewChanged = true;
+
+    uniforms.iterations = iterations;
+    uniforms.glitchTol  = glitchTolerance;
+
+    // new primary reference at view center
+    if(viewChanged) uploadOrbit(0, cx, cy);
+    if(viewChanged || gridChanged) {
+        // old glitch state is meaningless (secondary reference: pixel position in the old grid)
+        uniforms.refLen1    = 0;
+        uniforms.refOffset1 = int32_t(orbitCapacity);
+        uniforms.wSizeX     = float(wSize[0]);
+        uniforms.wSizeY     = float(wSize[1]);
+        uniforms.refPos0X   = uniforms.wSizeX * .5f;
+        uniforms.refPos0Y   = uniforms.wSizeY * .5f;
+        // both axis share the exponent of the larger scale
+        const int32_t e   = std::max(sx.e, sy.e);
+        uniforms.scaleE   = e;
+        uniforms.scaleMX  = float(std::ldexp(sx.m, sx.e - e));
+        uniforms.scaleMY  = float(std::ldexp(sy.m, sy.e - e));
+        encoder.ClearBuffer(glitchMaskBuffer, 0, wgpu::kWholeSize);
+        viewChanged = gridChanged = false;
+        viewEpoch++;
+    }
+    secondaryChanged = false;
+    device.GetQueue().WriteBuffer(ubo, 0, &uniforms, sizeof(uniformData));
+
+    if(rebind) {
+        wgpu::BindGroupEntry entries[6];
+        entries[0].binding = 0; entries[0].buffer = ubo;              entries[0].size = sizeof(uniformData);
+        entries[1].binding = 1; entries[1].buffer = orbitBuffer;      entries[1].size = wgpu::kWholeSize;
+        entries[2].binding = 2; entries[2].buffer = glitchMaskBuffer; entries[2].size = wgpu::kWholeSize;
+        entries[3].binding = 3; entries[3].buffer = glitchBuffer;     entries[3].size = wgpu::kWholeSize;
+        entries[4].binding = 4; entries[4].buffer = blaBuffer;        entries[4].size = wgpu::kWholeSize;
+        entries[5].binding = 5; entries[5].textureView = iterationView;
+        wgpu::BindGroupDescriptor descBindGroup;
+        descBindGroup.layout     = bindGroupLayout;
+        descBindGroup.entryCount = 6;
+        descBindGroup.entries    = entries;
+        bindGroup = device.CreateBindGroup(&descBindGroup);
+        boundView = iterationView.Get();
+    }
+}
+
+void mandelPerturb::compute(const wgpu::CommandEncoder &encoder, int32_t iterations, const wgpu::TextureView &iterationView,
+                            const computeTimestampWrites *timestamps)
+{
+    update(encoder, iterations, iterationView);
+
+    wgpu::ComputePassDescriptor descPass;
+    descPass.timestampWrites = timestamps;
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&descPass);
+    pass.SetPipeline(pipeline);
+    pass.SetBindGroup(0, bindGroup, 0, nullptr);
+    pass.DispatchWorkgroups((wSize[0] + 7) / 8, (wSize[1] + 7) / 8, 1);
+    pass.End();
+
+    // glitch counters readback
+    if(glitchReadback.copyFrom(encoder, glitchBuffer)) copiedEpoch = viewEpoch;
+    encoder.ClearBuffer(glitchBuffer, 0, wgpu::kWholeSize);     // every frame counts its own glitches
+}
+
+void mandelPerturb::afterSubmit()
+{
+    if(glitchReadback.isMapped()) {
+        const uint32_t *data = (const uint32_t *) glitchReadback.data();
+        const uint32_t count = data[0], sample = data[1];
+        glitchReadback.release();
+
+        if(copiedEpoch == viewEpoch) {
+            lastGlitchCount = count;
+            // glitched pixels and no secondary reference yet: build it on one of them
+            if(count && !uniforms.refLen1) {
+                uniforms.refPos1X = float(sample & 0xffffu) + .5f;
+                uniforms.refPos1Y = float(sample >> 16)     + .5f;
+                // C2 = C + (refPos1 - wSize/2) / wSize * 2 * mScale
+                mpFixed rx = cx, ry = cy, d(cx.size());
+                d.set(sx * (double(uniforms.refPos1X - uniforms.refPos0X) * 2. / double(wSize[0]))); rx += d;
+                d.set(sy * (double(uniforms.refPos1Y - uniforms.refPos0Y) * 2. / double(wSize[1]))); ry += d;
+                uploadOrbit(1, rx, ry);
+                secondaryChanged = true;    // glitched pixels need a new compute()
+            }
+        }
+    } else glitchReadback.release();    // failed map: retry
+    glitchReadback.requestMap();
+}
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Perturbation deep zoom (beyond f32 precision of shaderData_)
+//   - view kept at arbitrary precision: center (mpFixed), half size (expDouble)
+//   - reference orbit computed on CPU and uploaded as storage buffer
+//   - mandel_perturb.wgsl (compute) iterates only the pixel delta and writes the
+//     smooth iteration count in the iteration texture of mandelCompute
+//   - glitched pixels (Pauldelbrot criterion, or reference escaped too early) are
+//     flagged by the shader and re-rendered from a secondary reference
+//   - bilinear approximation (BLA) table of the primary reference: the shader
+//     skips blocks of 2^k iterations while dz stays in their validity radius
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "mpFixed.h"
+#include "wgpuUtils.h"
+
+// Z(0) = 0, Z(n+1) = Z(n)^2 + C, up to escape (|Z|^2 > 16) or maxIter elements
+// orbit receives Z(0) .. Z(len-1) as f32 pairs, returns len
+int computeReferenceOrbit(const mpFixed &cx, const mpFixed &cy, int maxIter, std::vector<float> &orbit);
+
+// BLA: dz(n+l) = A dz(n) + B dc, valid while |dz(n)| < R (A, B as mantissa * 2^exp)
+// must match blaData in mandel_perturb.wgsl
+struct blaEntry {
+    float   ax, ay, bx, by;
+    int32_t ae, be;
+    float   logR;           // log2(R), -1e30 when never valid
+    int32_t pad;
+};
+constexpr int blaMaxLevels = 32;
+
+// level k has (len-2) >> k entries, entry j skips 2^k iterations from n = 1 + j * 2^k
+// epsilonLog2: dropped non linear term |dz|^2 < 2^epsilonLog2 * |A dz| (error tolerance)
+// dcMax: max |dc| of the view; returns number of levels, levelOffset[k]: first entry of level k
+int buildBLA(const std::vector<float> &orbit, int len, expDouble dcMax, int epsilonLog2,
+             std::vector<blaEntry> &table, int32_t levelOffset[blaMaxLevels]);
+
+class mandelPerturb {
+public:
+    // must match perturbData in mandel_perturb.wgsl
+    struct alignas(16) uniformData {
+        float   scaleMX, scaleMY;
+        float   wSizeX, wSizeY;
+        float   refPos0X, refPos0Y;
+        float   refPos1X, refPos1Y;
+        int32_t scaleE, iterations;
+        int32_t refLen0, refLen1, refOffset1;
+        float   glitchTol;
+        int32_t blaLevels, blaCount0;
+        int32_t blaOffset[blaMaxLevels];
+    };
+
+    // High precision view: same meaning of mTransp (center) and mScale (half size) of shaderData_
+    void setView(double cx, double cy, double sx, double sy, uint32_t w, uint32_t h);
+    void zoom(double offX, double offY, float scale);   // same rule of zoom(): off = cursor offset from center in [-1, 1]
+    void resize(uint32_t w, uint32_t h);                // same rule of appResizeArea()
+    void setGrid(uint32_t w, uint32_t h);               // render scale: new pixel grid, same center and half size
+
+    double    centerX() const { return cx.toDouble(); }
+    double    centerY() const { return cy.toDouble(); }
+    const mpFixed &centerXmp() const { return cx; }
+    const mpFixed &centerYmp() const { return cy; }
+    expDouble scaleX()  const { return sx; }
+    expDouble scaleY()  const { return sy; }
+    uint32_t  width()   const { return wSize[0]; }
+    uint32_t  height()  const { return wSize[1]; }
+
+    // pixel size below the resolution of coordinates with mantissaBits (f32: 24, df64: 48)
+    bool belowResolution(int mantissaBits) const;
+
+    // GPU side
+    void init(const wgpu::Device &device);
+    bool needsUpdate() const;       // view, BLA settings or secondary reference changed since last compute()
+    void compute(const wgpu::CommandEncoder &encoder, int32_t iterations, const wgpu::TextureView &iterationView,
+                 const computeTimestampWrites *timestamps = nullptr);
+    void afterSubmit();             // after queue.Submit()
+    bool isBusy() const { return needsUpdate() || !glitchReadback.isIdle(); }  // more frames needed (render on demand)
+
+    // stats
+    int   referenceLength(int ref) const { return ref ? uniforms.refLen1 : uniforms.refLen0; }
+    uint32_t glitchedPixels() const { return lastGlitchCount; }
+    int   precisionBits() const { return cx.precisionBits(); }
+
+    float glitchTolerance = 1e-6f;
+    bool  useBLA = true;
+    int   blaToleranceLog2 = -24;     // BLA error tolerance: 2^-24 ~ f32 epsilon
+
+private:
+    void updatePrecision();
+    void uploadOrbit(int ref, const mpFixed &rx, const mpFixed &ry);
+    void update(const wgpu::CommandEncoder &encoder, int32_t iterations, const wgpu::TextureView &iterationView);
+
+    // view
+    mpFixed   cx { 4 }, cy { 4 };
+    expDouble sx { 1.5 }, sy { 1.5 };
+    uint32_t  wSize[2] = { 1, 1 };
+    bool      viewChanged = true;
+    bool      gridChanged = false;    // same view, other pixel grid: reference orbit still valid
+    bool      secondaryChanged = false;
+    uint32_t  viewEpoch = 0, copiedEpoch = 0;
+
+    // gpu
+    wgpu::Device          device;
+    wgpu::ComputePipeline pipeline;
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::BindGroup       bindGroup;
+    WGPUTextureView       boundView = nullptr;   // iteration texture of current bindGroup
+    wgpu::Buffer          ubo, orbitBuffer, glitchMaskBuffer, glitchBuffer, blaBuffer;
+    asyncReadback         glitchReadback;
+    uint32_t              orbitCapacity = 0;     // elements for every reference
+    uint32_t              maskSize[2] = { 0, 0 };
+    uniformData           uniforms {};
+    uint32_t              lastGlitchCount = 0;
+    std::vector<float>    orbitData;
+    std::vector<blaEntry> blaTable;
+    int                   blaBuiltWith = 0;      // blaToleranceLog2 of current table, 0: no table
+};
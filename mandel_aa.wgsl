@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Sub-pixel sampling, appended to mandel.wgsl / mandel_df64.wgsl (it uses their
+//  escapeAt() and smoothIter()), dispatched after cs()
+//   - csRefine(): edge-adaptive antialiasing, only pixels whose smooth count
+//     differs from a neighbour more than threshold (or inside / outside
+//     mismatch) take n x n stratified jittered samples: their counts go in
+//     aaSamples, averaged after the palette in mandel_color.wgsl
+//   - csAccumulate(): temporal accumulation while the view is still, one
+//     sample per frame at acc.jitter added to the color sum of the pixel (flat
+//     pixels, without edges, add their center color: no iterations)
+//------------------------------------------------------------------------------
+R"(
+    struct aaData {
+        samples   : u32,        // 4 (2 x 2) or 16 (4 x 4) per refined pixel, 0: off
+        capacity  : u32,        // refined pixels that fit in aaSamples
+        threshold : f32,        // smooth count difference of an edge
+    };
+    @group(0) @binding(3) var iterIn : texture_2d<f32>;                                  // written by cs() just before
+    @group(0) @binding(4) var<uniform> aa : aaData;
+    @group(0) @binding(5) var<storage, read_write> aaSlot : array<u32>;                  // per pixel, 0: single sample, k: aaSamples[k - 1]
+    @group(0) @binding(6) var<storage, read_write> aaSamples : array<array<vec4f, 4>>;   // up to 16 smooth counts
+    @group(0) @binding(7) var<storage, read_write> aaCount : atomic<u32>;                // edge pixels found (also over capacity)
+
+    struct accumData {
+        count     : u32,        // colors in history (this frame included), 0: not accumulating
+        threshold : f32,        // edge threshold, as aaData
+        jitter    : vec2f,      // sample position of this frame in the pixel, [0, 1)
+    };
+    @group(0) @binding(8)  var<uniform> acc : accumData;
+    @group(0) @binding(9)  var<storage, read_write> history : array<vec4f>;   // rgb: sum of colors, a: their count
+    @group(0) @binding(10) var paletteTex : texture_2d<f32>;                   // as mandel_color.wgsl
+    @group(0) @binding(11) var paletteSampler : sampler;
+
+    fn isEdge(p: vec2i, size: vec2i, threshold: f32) -> bool
+    {
+        let mu = textureLoad(iterIn, p, 0).r;
+        for (var dy = -1; dy <= 1; dy = dy + 1) {
+            for (var dx = -1; dx <= 1; dx = dx + 1) {
+                let q = p + vec2i(dx, dy);
+                if (any(q < vec2i(0)) || any(q >= size)) { continue; }
+                let m = textureLoad(iterIn, q, 0).r;
+                if ((m > 0.) != (mu > 0.) || abs(m - mu) > threshold) { return true; }
+            }
+        }
+        return false;
+    }
+
+    // jitter: same pattern on every compute of the same view (no flickering)
+    fn hash(v: vec3u) -> u32
+    {
+        var h = (v.x * 0x8da6b343u) ^ (v.y * 0xd8163841u) ^ (v.z * 0xcb1ab31fu);
+        h = (h ^ (h >> 16u)) * 0x7feb352du;
+        h = (h ^ (h >> 15u)) * 0x846ca68bu;
+        return h ^ (h >> 16u);
+    }
+
+    @compute @workgroup_size(8, 8) fn csRefine(@builtin(global_invocation_id) id: vec3u)
+    {
+        let size = textureDimensions(iterIn);
+        if (any(id.xy >= size) || !isEdge(vec2i(id.xy), vec2i(size), aa.threshold)) { return; }    // aaSlot is cleared before the pass
+        let slot = atomicAdd(&aaCount, 1u);
+        if (slot >= aa.capacity) { return; }
+
+        let n = select(2u, 4u, aa.samples > 4u);
+        var mu: array<vec4f, 4>;
+        for (var k = 0u; k < n * n; k = k + 1u) {
+            let h = hash(vec3u(id.xy, k));
+            let jitter = vec2f(f32(h & 0xffffu), f32(h >> 16u)) / 65536.;
+            let offset = (vec2f(f32(k % n), f32(k / n)) + jitter) / f32(n);
+            mu[k / 4u][k % 4u] = smoothIter(escapeAt(vec2f(id.xy) + offset));
+        }
+        aaSamples[slot] = mu;
+        aaSlot[id.y * size.x + id.x] = slot + 1u;
+    }
+
+    fn paletteColor(mu: f32) -> vec3f
+    {
+        if (mu <= 0.) { return vec3f(0.); }
+        let u: f32 = fract(sd.shift + mu / f32(sd.nColors));
+        return textureSampleLevel(paletteTex, paletteSampler, vec2f(u, .5), 0.).rgb;
+    }
+
+    @compute @workgroup_size(8, 8) fn csAccumulate(@builtin(global_invocation_id) id: vec3u)
+    {
+        let size = textureDimensions(iterIn);
+        if (any(id.xy >= size)) { return; }
+        let idx = id.y * size.x + id.x;
+
+        let center = paletteColor(textureLoad(iterIn, vec2i(id.xy), 0).r);
+        var rgb = center;
+        if (isEdge(vec2i(id.xy), vec2i(size), acc.threshold)) { rgb = paletteColor(smoothIter(escapeAt(vec2f(id.xy) + acc.jitter))); }
+
+        // first frame: the center sample of cs() is the first color
+        let sum = select(vec4f(center, 1.), history[idx], acc.count > 2u);
+        history[idx] = sum + vec4f(rgb, 1.);
+    }
+)"
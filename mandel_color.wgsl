@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Colorize pass: one texture read per pixel from the iteration texture written
+//  by cs() (mandel.wgsl, mandel_df64.wgsl, mandel_perturb.wgsl) and one filtered
+//  sample of the palette LUT (palette.h) at shift + mu / nColors
+//  Pixels refined by mandel_aa.wgsl average the colors of all their samples,
+//  while accumulating (csAccumulate()) every pixel shows the mean of its history
+//  The iteration texture can be smaller than the surface (render scale): every
+//  fragment reads its nearest texel (uv of vs()), the same pixel at native size
+//------------------------------------------------------------------------------
+R"(
+    struct shaderData {
+        mScale      : vec2f,
+        mTransp     : vec2f,
+        wSize       : vec2f,
+        iterations  : i32,
+        nColors     : i32,
+        shift       : f32,
+    };
+    @group(0) @binding(0) var<uniform> sd : shaderData;
+    @group(0) @binding(1) var iterTex : texture_2d<f32>;
+    @group(0) @binding(2) var paletteTex : texture_2d<f32>;        // palette::lutSize x 1, one cycle
+    @group(0) @binding(3) var paletteSampler : sampler;            // linear, repeat on u
+    struct aaData {             // as mandel_aa.wgsl
+        samples   : u32,
+        capacity  : u32,
+        threshold : f32,
+    };
+    @group(0) @binding(4) var<uniform> aa : aaData;
+    @group(0) @binding(5) var<storage, read> aaSlot : array<u32>;
+    @group(0) @binding(6) var<storage, read> aaSamples : array<array<vec4f, 4>>;
+    struct accumData {          // as mandel_aa.wgsl
+        count     : u32,
+        threshold : f32,
+        jitter    : vec2f,
+    };
+    @group(0) @binding(7) var<uniform> acc : accumData;
+    @group(0) @binding(8) var<storage, read> history : array<vec4f>;
+
+    struct vsOut {
+        @builtin(position) position : vec4f,
+        @location(0)       uv       : vec2f,       // 0..1, top-left origin
+    };
+
+    @vertex fn vs(@builtin(vertex_index) VertexIndex : u32) -> vsOut
+    {
+        // use "in-place" position (w/o vetrex buffer): 4 vetex / triangleStrip
+        var pos = array( vec2f(-1.0,  1.0),
+                         vec2f(-1.0, -1.0),
+                         vec2f( 1.0,  1.0),
+                         vec2f( 1.0, -1.0)  );
+        var out : vsOut;
+        out.position = vec4f(pos[VertexIndex], 0, 1);
+        out.uv       = pos[VertexIndex] * vec2f(.5, -.5) + .5;
+        return out;
+    }
+
+    // fract: texel coords stay small for high counts, repeat filters the seam of the cycle
+    // explicit level: no derivatives, so no uniform control flow required
+    fn palette(mu: f32) -> vec3f
+    {
+        let u: f32 = fract(sd.shift + mu / f32(sd.nColors));
+        return textureSampleLevel(paletteTex, paletteSampler, vec2f(u, .5), 0.).rgb;
+    }
+
+    // iteration texture smaller than the surface (adaptive render scale): nearest texel, exact at 1:1
+    @fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f
+    {
+        let dims = textureDimensions(iterTex);
+        let p = min(vec2u(uv * vec2f(dims)), dims - 1u);
+        let idx = p.y * dims.x + p.x;
+        if (acc.count > 0u) {
+            let h = history[idx];
+            return vec4f(h.rgb / h.a, 1.);
+        }
+
+        var slot = 0u;
+        if (aa.samples > 0u) { slot = aaSlot[idx]; }        // AA off: aaSlot is a placeholder
+        if (slot != 0u) {
+            let n = select(4u, 16u, aa.samples > 4u);
+            var rgb = vec3f(0.);
+            for (var k = 0u; k < n; k = k + 1u) {
+                let mu = aaSamples[slot - 1u][k / 4u][k % 4u];
+                if (mu > 0.0) { rgb += palette(mu); }
+            }
+            return vec4f(rgb / f32(n), 1.);
+        }
+
+        let mu: f32 = textureLoad(iterTex, vec2i(p), 0).r;
+        if (mu <= 0.0) { return vec4f(0.); }
+        return vec4f(palette(mu), 1.);
+    }
+)"
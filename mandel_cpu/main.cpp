@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  CPU fallback of the web examples (cpuFallback) without browser: kernel and
+//  worker pool checked against the scalar kernel, bit by bit, on some views.
+//  Native, or Emscripten for Node (pthreads are Node worker_threads):
+//      node build/mandel_cpu.js --threads=4
+//  returns 0 if every view matches
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#include "cpuFallback.h"
+
+static uint32_t imageWidth  {1021};             // odd: partial tiles and SIMD tail lanes
+static uint32_t imageHeight {769};
+static unsigned threads     {0};                // 0: all cores (at most cpuFallback::maxThreads)
+static int32_t  iterations  {1024};
+static const char *kernelName {"auto"};
+static const char *outFileName {nullptr};       // PPM of the first view
+
+struct view { const char *name; float cx, cy, scale; };
+static const view views[] = {
+    { "whole set",        -.75f,       0.f,     1.5f   },
+    { "seahorse valley",  -.743643f,   .131825f, .0025f },
+    { "elephant valley",   .2925f,     .0165f,   .002f  },
+    { "cardioid (interior)", -.2f,     0.f,      .05f   },
+};
+
+static mandelCPU::params viewParams(const view &v)
+{
+    const float aspect = float(imageWidth) / float(imageHeight);
+    return { v.scale * aspect, v.scale, v.cx, v.cy, float(imageWidth), float(imageHeight), iterations, 256, 0.f };
+}
+
+static bool writePPM(const char *name, const cpuFallback &r)
+{
+    FILE *f = fopen(name, "wb");
+    if(!f) return false;
+    fprintf(f, "P6\n%u %u\n255\n", r.width(), r.height());
+    const uint8_t *p = r.pixels();
+    std::vector<uint8_t> row(size_t(r.width()) * 3);
+    for(uint32_t y = 0; y < r.height(); y++) {
+        for(uint32_t x = 0; x < r.width(); x++, p += 4) { row[x * 3] = p[0]; row[x * 3 + 1] = p[1]; row[x * 3 + 2] = p[2]; }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    return fclose(f) == 0;
+}
+
+static bool parseArgs(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        auto isOpt = [&](const char *opt) { size_t len = strlen(opt); return !strncmp(arg, opt, len) ? arg + len : nullptr; };
+        const char *val;
+        if     ((val = isOpt("--size=")))       { if(sscanf(val, "%ux%u", &imageWidth, &imageHeight) != 2) return false; }
+        else if((val = isOpt("--threads=")))    threads = unsigned(atoi(val));
+        else if((val = isOpt("--iterations="))) iterations = atoi(val);
+        else if((val = isOpt("--cpu=")))        {
+            if(mandelCPU::kernelFromName(val) == mandelCPU::kernel::Count) { printf("unknown CPU kernel: %s\n", val); return false; }
+            kernelName = val;
+        }
+        else if((val = isOpt("--out=")))        outFileName = val;
+        else return false;
+    }
+    return imageWidth > 0 && imageHeight > 0 && iterations > 1;
+}
+
+// Main code
+int main(int argc, char** argv)
+{
+    if(!parseArgs(argc, argv)) {
+        printf("usage: %s [options]\n"
+               "  --size=WxH              view size                (default %ux%u)\n"
+               "  --threads=N             pool threads             (default 0: all cores, at most %u)\n"
+               "  --iterations=N          max iterations           (default %d)\n"
+               "  --cpu=KERNEL            auto | scalar | sse4.2 | avx2 | avx512 | wasm-simd128\n"
+               "  --out=file.ppm          write the first view\n", argv[0], imageWidth, imageHeight, cpuFallback::maxThreads, iterations);
+        return -1;
+    }
+
+    cpuFallback renderer;
+    renderer.init(threads, mandelCPU::kernelFromName(kernelName));
+    printf("%ux%u, %d iterations, kernel %s x %u threads\n", imageWidth, imageHeight, iterations,
+           mandelCPU::kernelName(renderer.usedKernel()), renderer.threads());
+
+    bool ok = true;
+    std::vector<int32_t> reference;
+    for(const view &v : views) {
+        const mandelCPU::params p = viewParams(v);
+        const mandelCPU::stats single = mandelCPU::render(mandelCPU::kernel::Scalar, p, reference);
+        const mandelCPU::stats multi  = renderer.render(p);
+        const bool same = !memcmp(renderer.iterations(), reference.data(), reference.size() * sizeof(int32_t));
+        ok &= same;
+        printf("%-20s scalar %8.2f Mpixel/s, pool %8.2f Mpixel/s %7.3f Giga-iterations/s (%.2fx)  %s\n", v.name,
+               single.mPixelsPerSec(), multi.mPixelsPerSec(), multi.gIterPerSec(), single.seconds / multi.seconds,
+               same ? "bit-exact" : "MISMATCH");
+        if(outFileName && &v == views && !writePPM(outFileName, renderer)) { printf("Unable to write %s\n", outFileName); ok = false; }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Emulated double precision (double-single, df64): WGSL has no f64, so every
+//  value is an unevaluated sum hi + lo of two f32 (vec2f(hi, lo)), ~48 bits of
+//  mantissa: mid-range zooms (1e-6 .. 1e-13) at a fraction of perturbation cost
+//------------------------------------------------------------------------------
+R"(
+    struct shaderData {
+        mScale      : vec2f,
+        mTransp     : vec2f,
+        wSize       : vec2f,
+        iterations  : i32,
+        nColors     : i32,
+        shift       : f32,
+        interior    : i32,      // interior checks, as in mandel.wgsl
+        mScaleLo    : vec2f,    // df64 low parts: mScale + mScaleLo, mTransp + mTranspLo
+        mTranspLo   : vec2f,
+        one         : f32,      // always 1., unknown to the compiler: see the error-free transformations
+    };
+    @group(0) @binding(0) var<uniform> sd : shaderData;
+    @group(0) @binding(1) var iterTex : texture_storage_2d<r32float, write>;     // cs() only
+    struct pixelState {         // cs() only, as in mandel.wgsl
+        z  : vec4f,             // z(n): (x hi, x lo, y hi, y lo)
+        n  : i32,               // iterations done, < 0: escaped at -n
+        zz : f32,
+        err: f32,
+    };
+    @group(0) @binding(2) var<storage, read_write> state : array<pixelState>;
+    override resumable : bool = true;       // as in mandel.wgsl
+
+    @vertex fn vs(@builtin(vertex_index) VertexIndex : u32) -> @builtin(position) vec4f
+    {
+        // use "in-place" position (w/o vetrex buffer): 4 vetex / triangleStrip
+        var pos = array( vec2f(-1.0,  1.0),
+                         vec2f(-1.0, -1.0),
+                         vec2f( 1.0,  1.0),
+                         vec2f( 1.0, -1.0)  );
+        return vec4f(pos[VertexIndex], 0, 1);
+    }
+
+    fn hsl2rgb(hsl: vec3f) -> vec3f
+    {
+        let H: f32 = fract(hsl.x);
+        let rgb: vec3f = clamp(vec3f(abs(H * 6. - 3.) - 1., 2. - abs(H * 6. - 2.), 2. - abs(H * 6. - 4.)), vec3f(0.0), vec3f(1.0));
+        let C: f32 = (1. - abs(2. * hsl.z - 1.)) * hsl.y;
+        return (rgb - 0.5) * C + hsl.z;
+    }
+
+    // error-free transformations (Knuth / Dekker)
+    // N.B. exact only with IEEE f32 rounding of every single operation, in the written order:
+    //  - no FMA contraction: c - a in split(), ... - p in twoProd() fused with the product
+    //    before them (4097. * a, a * b) give the unrounded value and lo is garbage. WGSL lets
+    //    the backend (Metal, some Vulkan drivers) contract a * b + c, so these products go
+    //    through * sd.one: a product feeding a product can't be fused, and fusing x * one + y
+    //    rounds as x + y (partial products of split() halves are exact: free to fuse)
+    //  - no reassociation / fast math: (s - a) of quickTwoSum(), (s - v) of twoSum() folded away
+    //  keep these helpers as written (no fma(), no algebraic rewrites), and check a change
+    //  against perturbation at 1e-10 .. 1e-12 zoom (broken lo parts: f32-like blocks)
+    fn twoSum(a: f32, b: f32) -> vec2f
+    {
+        let s = a + b;
+        let v = s - a;
+        return vec2f(s, (a - (s - v)) + (b - v));
+    }
+    fn quickTwoSum(a: f32, b: f32) -> vec2f
+    {
+        let s = a + b;
+        return vec2f(s, b - (s - a));
+    }
+    fn split(a: f32) -> vec2f
+    {
+        let c = (4097. * a) * sd.one;       // 2^12 + 1, rounded before c - a
+        let hi = c - (c - a);
+        return vec2f(hi, a - hi);
+    }
+    fn twoProd(a: f32, b: f32) -> vec2f
+    {
+        let p  = (a * b) * sd.one;          // rounded before ... - p
+        let sa = split(a);
+        let sb = split(b);
+        return vec2f(p, ((sa.x * sb.x - p) + sa.x * sb.y + sa.y * sb.x) + sa.y * sb.y);
+    }
+
+    fn dfAdd(a: vec2f, b: vec2f) -> vec2f
+    {
+        var s = twoSum(a.x, b.x);
+        let t = twoSum(a.y, b.y);
+        s = quickTwoSum(s.x, s.y + t.x);
+        return quickTwoSum(s.x, s.y + t.y);
+    }
+    fn dfMul(a: vec2f, b: vec2f) -> vec2f
+    {
+        let p = twoProd(a.x, b.x);
+        return quickTwoSum(p.x, p.y + (a.x * b.y + a.y * b.x));
+    }
+
+    struct escape {
+        i  : i32,               // escape iteration, 0: inside the set (limit reached), -1: proven inside
+        zz : f32,               // |z|^2 at escape
+        z  : vec4f,             // last z: (x hi, x lo, y hi, y lo)
+    };
+
+    // position: pixel coords, c = sd.mTransp - sd.mScale + position / sd.wSize * (sd.mScale * 2.), in df64 (x hi, x lo, y hi, y lo)
+    fn pixelC(position: vec2f) -> vec4f
+    {
+        let t = position / sd.wSize;
+        let cx = dfAdd(dfAdd(vec2f(sd.mTransp.x, sd.mTranspLo.x), -vec2f(sd.mScale.x, sd.mScaleLo.x)),
+                       dfMul(vec2f(t.x, 0.), vec2f(sd.mScale.x, sd.mScaleLo.x) * 2.));
+        let cy = dfAdd(dfAdd(vec2f(sd.mTransp.y, sd.mTranspLo.y), -vec2f(sd.mScale.y, sd.mScaleLo.y)),
+                       dfMul(vec2f(t.y, 0.), vec2f(sd.mScale.y, sd.mScaleLo.y) * 2.));
+        return vec4f(cx, cy);
+    }
+
+    // same interior checks of mandel.wgsl
+    const interiorBulbs    = 1;
+    const interiorPeriodic = 2;
+    const provenInside     = 0x40000000;
+
+    // on hi parts only: a margin keeps pixels closer to the boundary than f32 can tell on the safe side (full iterations)
+    fn inCardioidOrBulb(c: vec4f) -> bool
+    {
+        let margin = 1e-6;
+        let x  = c.x - .25;
+        let y2 = c.z * c.z;
+        let q  = x * x + y2;
+        if (q * (q + x) <= .25 * y2 - margin) { return true; }
+        return (c.x + 1.) * (c.x + 1.) + y2 <= .0625 - margin;
+    }
+
+    // iterations first .. sd.iterations-1 starting from z0 = z(first - 1)
+    fn iterateFrom(c: vec4f, z0: vec4f, first: i32) -> escape
+    {
+        if (first == 1 && (sd.interior & interiorBulbs) != 0 && inCardioidOrBulb(c)) { return escape(-1, 0., z0); }
+
+        // Brent, with the df64 difference: eps is a fraction of the (df64) pixel
+        let periodic = (sd.interior & interiorPeriodic) != 0;
+        let eps = 1e-3 * 2. * sd.mScale.y / sd.wSize.y;
+        var sx = z0.xy;
+        var sy = z0.zw;
+        var lap = 0;
+        var lapLen = 8;
+
+        var zx = z0.xy;
+        var zy = z0.zw;
+
+        for (var i: i32 = first; i < sd.iterations; i = i + 1) {
+            // z = z^2 + c
+            let x2 = dfMul(zx, zx);
+            let y2 = dfMul(zy, zy);
+            let xy = dfMul(zx, zy);
+            zx = dfAdd(dfAdd(x2, -y2), c.xy);
+            zy = dfAdd(xy * 2., c.zw);  // *2 is exact on both parts
+            let zz = zx.x * zx.x + zy.x * zy.x;
+            if (zz > 16.) { return escape(i, zz, vec4f(zx, zy)); }
+            if (periodic) {
+                if (abs(dfAdd(zx, -sx).x) < eps && abs(dfAdd(zy, -sy).x) < eps) { return escape(-1, 0., vec4f(zx, zy)); }
+                lap = lap + 1;
+                if (lap == lapLen) { lap = 0; lapLen = lapLen * 2; sx = zx; sy = zy; }
+            }
+        }
+        return escape(0, 0., vec4f(zx, zy));
+    }
+
+    fn escapeTime(position: vec2f) -> escape { return iterateFrom(pixelC(position), vec4f(0.), 1); }
+    fn escapeAt(position: vec2f) -> escape { return escapeTime(position); }     // as mandel.wgsl (mandel_aa.wgsl)
+
+    fn smoothIter(e: escape) -> f32
+    {
+        if (e.i <= 0) { return 0.; }
+        return max(f32(e.i) + 1. - log2(.5 * log2(e.zz)), 1e-3);
+    }
+
+    @fragment fn fs(@builtin(position) position: vec4f) -> @location(0) vec4f
+    {
+        let clr: f32 = f32(escapeTime(position.xy).i) / f32(sd.nColors);
+
+        if (clr > 0.0) { return vec4f(hsl2rgb(vec3f(sd.shift + clr, 1., 0.5)), 1.); }
+        else           { return vec4f(0.); }
+    }
+
+    // same resume / re-clamp rules of cs() in mandel.wgsl
+    @compute @workgroup_size(8, 8) fn cs(@builtin(global_invocation_id) id: vec3u)
+    {
+        let size = textureDimensions(iterTex);
+        if (any(id.xy >= size)) { return; }
+        let idx = id.y * size.x + id.x;
+        var s = pixelState();
+        if (resumable) { s = state[idx]; }
+
+        if (s.n >= 0 && s.n + 1 < sd.iterations) {
+            let e = iterateFrom(pixelC(vec2f(id.xy) + .5), s.z, s.n + 1);
+            if (e.i > 0)      { s.n = -e.i; s.zz = e.zz; }
+            else if (e.i < 0) { s.n = provenInside; }
+            else              { s.n = sd.iterations - 1; s.z = e.z; }
+            if (resumable) { state[idx] = s; }
+        }
+
+        var mu = 0.;
+        if (s.n < 0 && -s.n < sd.iterations) { mu = smoothIter(escape(-s.n, s.zz, vec4f(0.))); }
+        textureStore(iterTex, id.xy, vec4f(mu, 0., 0., 1.));
+    }
+)"
@@ -12,8 +12,20 @@
 //------------------------------------------------------------------------------
 #include <cstdio>
 #include <cassert>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+
+#include "zoomBenchmark.h"
+#include "pipelineVariants.h"
+#if defined(MANDEL_CPU_FALLBACK)
+#include "cpuFallback.h"
+#endif
 
 #ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#include <emscripten/eventloop.h>
 #include <emscripten/html5.h>
 #include <emscripten/html5_webgpu.h>
 #include <GLFW/emscripten_glfw3.h>
@@ -36,6 +48,7 @@ struct alignas(16) shaderData_ {
     float wSizeX = initialWindowWidth, wSizeY = initialWindowHeight;
     int32_t iterations = 256, nColors = 256;
     float shift = 0.0;
+    int32_t interior = 3;       // interior checks of mandel.wgsl: 1 cardioid/bulb, 2 periodicity
 } shaderData;
 const float zoomFactor = .05;
 
@@ -51,13 +64,23 @@ wgpu::TextureFormat         preferredFormat { wgpu::TextureFormat::Undefined };
 wgpu::SurfaceConfiguration  surfaceConfig;
 
 // Pipeline related objs
-wgpu::RenderPipeline pipeline;
+wgpu::RenderPipeline pipeline;                  // fs() variant in use
+pipelineVariants     variants;
+pipelineVariants::variant wantedVariant;        // keys E / U / S / P: pipeline switches when it's ready
+pipelineVariants::variant drawnVariant;         // variant of pipeline
 wgpu::Buffer ubo;
 wgpu::BindGroupLayout bindGroupLayout;
 
+// Scripted zoom path (--benchmark): replaces the mouse, presentation uncapped
+zoomBenchmark benchmark;
+
 // Forward declarations
 static void updateUniformBuffer();
 
+// Render on demand: frames still to draw, when 0 mainLoop() does nothing and the loop waits for events
+int pendingFrames = 2;
+void requestRedraw(int frames = 2) { if(pendingFrames < frames) pendingFrames = frames; }
+
 // GLFW main framework window
 GLFWwindow* fwWindow;
 
@@ -83,6 +106,26 @@ void checkMouseButtonAction()
         zoom(zoomFactor);
 }
 
+// fs() variant keys (lowercase): the new pipeline is requested in mainLoop()
+void switchVariant(int key)
+{
+    static const float radii[] = { 2.f, 4.f, 16.f, 256.f };
+    pipelineVariants::variant &v = wantedVariant;
+    switch(key) {
+        case 'e': {     // next radius, back to the first after the last
+            float next = radii[0];
+            for(float r : radii) if(r > v.escapeRadius) { next = r; break; }
+            v.escapeRadius = next;
+        } break;
+        case 'u': v.unroll = v.unroll >= 8 ? 1 : v.unroll * 2; break;
+        case 's': v.smooth = !v.smooth;                      break;
+        case 'p': v.power  = v.power >= 5 ? 2 : v.power + 1; break;
+        default: return;
+    }
+    printf("escape radius %g, unroll %d, smooth %s, power %d\n", v.escapeRadius, v.unroll, v.smooth ? "on" : "off", v.power);
+    requestRedraw();
+}
+
 void appResizeArea(const  uint32_t w, const uint32_t h) // re-adjust aspect-ratio
 {
     static int width = w, height = h;
@@ -105,6 +148,29 @@ void initMandel()
 #endif
 }
 
+// benchmark: view of current frame (aspect-ratio of the window, as appResizeArea)
+void benchmarkView()
+{
+    const zoomBenchmark::keyframe v = benchmark.currentView();
+    shaderData.mTranspX   = float(v.cx);
+    shaderData.mTranspY   = float(v.cy);
+    shaderData.mScaleY    = float(v.scale);
+    shaderData.mScaleX    = float(v.scale * shaderData.wSizeX / shaderData.wSizeY);
+    shaderData.iterations = v.iterations;
+    updateUniformBuffer();
+}
+
+// after Present: path completed, report written -> quit
+void benchmarkFrameDone()
+{
+    if(!benchmark.isRunning() || !benchmark.frameDone(surfaceConfig.width, surfaceConfig.height)) return;
+#if defined(__EMSCRIPTEN__)
+    emscripten_cancel_main_loop();
+#else
+    glfwSetWindowShouldClose(fwWindow, GLFW_TRUE);
+#endif
+}
+
 // WGPU VL callbacks
 #if !defined(__EMSCRIPTEN__)
 static void wgpu_device_lost_callback(const wgpu::Device&, wgpu::DeviceLostReason reason, wgpu::StringView message)
@@ -162,9 +228,10 @@ void initWGPU()
     auto waitStatus = instance.WaitAny(waitedAdapterFunc, UINT64_MAX);
     assert(localAdapter != nullptr && waitStatus == wgpu::WaitStatus::Success && "Error on Adapter request");
 
-#ifndef NDEBUG
     wgpu::AdapterInfo info;
     localAdapter.GetInfo(&info);
+    benchmark.setAdapter(info.device.data);
+#ifndef NDEBUG
     printf("Using adapter: \" %s \"\n", info.device.data);
 #endif
 
@@ -192,27 +259,43 @@ void initWGPU()
     surfaceConfig.height          = initialWindowHeight;
     surfaceConfig.alphaMode       = wgpu::CompositeAlphaMode::Auto;
     surfaceConfig.presentMode     = wgpu::PresentMode::Fifo;
+    // benchmark: don't wait vsync (Immediate, otherwise Mailbox) if available
+    if(benchmark.isRequested())
+        for(size_t i = 0; i < capabilities.presentModeCount; i++)
+            if(capabilities.presentModes[i] == wgpu::PresentMode::Immediate ||
+              (capabilities.presentModes[i] == wgpu::PresentMode::Mailbox && surfaceConfig.presentMode == wgpu::PresentMode::Fifo))
+                surfaceConfig.presentMode = capabilities.presentModes[i];
 
     surface.Configure(&surfaceConfig);
 }
 #else
-// Adapter and device initialization via JS
-EM_ASYNC_JS( void, getAdapterAndDeviceViaJS, (),
+// Adapter and device requested via JS promises: no ASYNCIFY, the call returns at once
+// and onDeviceReady() continues the startup (main loop started only with a device)
+EM_JS( void, requestAdapterAndDeviceViaJS, (),
 {
-    if (!navigator.gpu) throw Error("WebGPU not supported.");
-
-    const adapter = await navigator.gpu.requestAdapter();
-    const device = await adapter.requestDevice();
-    Module.preinitializedWebGPUDevice = device;
+    // always asynchronous, also without navigator.gpu: onDeviceReady() runs after main() returns
+    (navigator.gpu ? navigator.gpu.requestAdapter() : Promise.reject(Error("WebGPU not supported.")))
+        .then((adapter) => {
+            if (!adapter) throw Error("No WebGPU adapter.");
+            Module.adapterName = adapter.info ? (adapter.info.device || adapter.info.description || adapter.info.vendor) : "";
+            return adapter.requestDevice();
+        })
+        .then((device) => { Module.preinitializedWebGPUDevice = device; _onDeviceReady(1); },
+              (error)  => { console.error(error); _onDeviceReady(0); });
 } );
 
+// adapter name stored by requestAdapterAndDeviceViaJS() (GPUAdapterInfo: can be empty), malloc'ed
+EM_JS_DEPS(adapterNameDeps, "$stringToNewUTF8");
+EM_JS( char *, adapterNameViaJS, (), { return stringToNewUTF8(Module.adapterName || ""); } );
+
 void initWGPU()
 {
-    getAdapterAndDeviceViaJS();
-
     instance = wgpu::CreateInstance(nullptr);
     device   = wgpu::Device(emscripten_webgpu_get_device());
     assert(device != nullptr && "Error creating the Device");
+    char *adapterName = adapterNameViaJS();
+    benchmark.setAdapter(*adapterName ? adapterName : nullptr);
+    free(adapterName);
 
     wgpu::SurfaceDescriptorFromCanvasHTMLSelector html_surface_desc;
     html_surface_desc.selector = "#canvas";
@@ -243,43 +326,6 @@ void initRenderPipeline()
     shaderDescriptor.nextInChain = &wgslDesc;
     wgpu::ShaderModule module = device.CreateShaderModule(&shaderDescriptor);
 
-    wgpu::RenderPipelineDescriptor descPipeline;
-    descPipeline.layout = nullptr;
-    descPipeline.vertex.module = module;
-    descPipeline.vertex.bufferCount = 0;
-
-    // Set primitive state
-    descPipeline.primitive.topology         = wgpu::PrimitiveTopology::TriangleStrip;
-    descPipeline.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
-    descPipeline.primitive.frontFace        = wgpu::FrontFace::CCW;
-    descPipeline.primitive.cullMode         = wgpu::CullMode::None;
-
-    // BlendComponent
-    wgpu::BlendComponent blendComponent {
-        .operation = wgpu::BlendOperation::Add,
-        .srcFactor = wgpu::BlendFactor::One,
-        .dstFactor = wgpu::BlendFactor::Zero,
-    };
-    // Blend
-    wgpu::BlendState blend {
-        .color = blendComponent,
-        .alpha = blendComponent,
-    };
-    // color target attribs
-    wgpu::ColorTargetState colorTarget {
-        .nextInChain = nullptr,
-        .format      = wgpu::TextureFormat(preferredFormat),
-        .blend       = &blend,
-        .writeMask   = wgpu::ColorWriteMask::All,
-    };
-
-    // Fragment Shader
-    wgpu::FragmentState fragment;
-    fragment.module = module;
-    fragment.targetCount = 1;
-    fragment.targets = &colorTarget;
-    descPipeline.fragment = &fragment;
-
     // Uniform Buffer
     wgpu::BufferDescriptor bufferDesc {
         .nextInChain      = nullptr,
@@ -308,14 +354,17 @@ void initRenderPipeline()
     layoutDesc.bindGroupLayoutCount = 1;
     layoutDesc.bindGroupLayouts = &bindGroupLayout;
     wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&layoutDesc);
-    descPipeline.layout = pipelineLayout;
 
-    // Create Render Pipeline
-    pipeline = device.CreateRenderPipeline(&descPipeline);
+    // fs() specialised by the override constants of mandel.wgsl (FragmentState::constants):
+    // the first variant is built here, the others asynchronously when switched to
+    variants.init(device, module, pipelineLayout, preferredFormat);
+    pipeline = variants.create(wantedVariant);
+    drawnVariant = wantedVariant;
 }
 
 static void updateUniformBuffer() {
-    device.GetQueue().WriteBuffer( ubo, 0, &shaderData, sizeof( shaderData_ ) );
+    if(ubo) device.GetQueue().WriteBuffer( ubo, 0, &shaderData, sizeof( shaderData_ ) );    // no ubo: CPU fallback
+    requestRedraw();
 }
 
 void resizeSurface(const uint32_t width, const uint32_t height)
@@ -324,6 +373,7 @@ void resizeSurface(const uint32_t width, const uint32_t height)
     surfaceConfig.height = height;
 
     surface.Configure(&surfaceConfig);
+    requestRedraw();
 }
 
 WGPUTexture checkTextureStatus()
@@ -352,6 +402,7 @@ WGPUTexture checkTextureStatus()
                 surfaceConfig.height = height;
 
                 surface.Configure(&surfaceConfig);
+                requestRedraw();
             }
             return nullptr;
         }
@@ -364,8 +415,11 @@ WGPUTexture checkTextureStatus()
 
 void mainLoop()
 {
-    // check for click: Mandelbrot zoomIn / zoomOut
-    checkMouseButtonAction();
+    // minimized: suspended (0 x 0 framebuffer, nothing to present)
+    if(glfwGetWindowAttrib(fwWindow, GLFW_ICONIFIED) != 0) return;
+
+    // check for click: Mandelbrot zoomIn / zoomOut (not while the benchmark drives the view)
+    if(!benchmark.isRunning()) checkMouseButtonAction();
 
     // React to changes in screen size
     int width, height;
@@ -376,6 +430,20 @@ void mainLoop()
         appResizeArea(width, height); // re-adjust Mandelbrot aspect-ratio
     }
 
+    if(benchmark.isRunning()) benchmarkView();
+
+    // fs() variant: the current pipeline draws until the wanted one is built (never waits)
+    if(const wgpu::RenderPipeline *ready = variants.request(wantedVariant)) {
+        if(ready->Get() != pipeline.Get()) { pipeline = *ready; drawnVariant = wantedVariant; requestRedraw(); }
+    } else if(variants.failed(wantedVariant)) {            // back to the variant on screen: the next key press builds again
+        printf("fs() variant not available, kept escape radius %g, unroll %d, smooth %s, power %d\n", drawnVariant.escapeRadius,
+               drawnVariant.unroll, drawnVariant.smooth ? "on" : "off", drawnVariant.power);
+        wantedVariant = drawnVariant;
+    } else if(variants.isBuilding()) requestRedraw(1);     // keep ticking the device until its callback
+
+    // nothing changed from last frame: no encode, no submit, no present
+    if(!pendingFrames) return;
+
     wgpu::Texture texture = checkTextureStatus();
     if(!texture) return;
 
@@ -455,11 +523,89 @@ void mainLoop()
     // Tick needs to be called in Dawn to display validation errors
     device.Tick();
 #endif
+    pendingFrames--;
+    benchmarkFrameDone();
+}
+
+// device ready: surface configured by initWGPU(), pipelines
+void initGraphics()
+{
+    glfwShowWindow(fwWindow);
+
+    initRenderPipeline();
+    initMandel();
+    benchmark.addInfo("interior", shaderData.interior);
+    benchmark.addInfo("unroll", wantedVariant.unroll);
+    benchmark.addInfo("power", wantedVariant.power);
+    if(benchmark.isRequested()) benchmark.start("mandel_glfw");
 }
 
+#if defined(MANDEL_CPU_FALLBACK)
+// No WebGPU (no navigator.gpu, adapter or device): same view and mouse zoom rendered by the CPU
+// (WASM SIMD128 kernel on a pool of WebWorkers) and blitted to the canvas
+cpuFallback fallback;
+
+void fallbackLoop()
+{
+    // check for click: Mandelbrot zoomIn / zoomOut
+    checkMouseButtonAction();
+
+    // React to changes in screen size
+    int width, height;
+    glfwGetFramebufferSize(fwWindow, &width, &height);
+    if(width > 0 && height > 0 && (float(width) != shaderData.wSizeX || float(height) != shaderData.wSizeY))
+        appResizeArea(width, height); // re-adjust Mandelbrot aspect-ratio
+
+    if(!pendingFrames) return;
+    fallback.render(mandelCPU::fromShaderData(shaderData));
+    fallback.blit("#canvas");
+    pendingFrames = 0;      // nothing to accumulate: one frame is the final image
+}
+#endif
+
+#ifdef __EMSCRIPTEN__
+// Startup state machine (web): main() -> requestAdapterAndDeviceViaJS() -> onDeviceReady() -> main loop
+extern "C" EMSCRIPTEN_KEEPALIVE void onDeviceReady(int ok)
+{
+    emscripten_runtime_keepalive_pop();
+    if(!ok) {
+#if defined(MANDEL_CPU_FALLBACK)
+        fallback.init();
+        printf("WebGPU device not available: CPU fallback, %s x %u threads\n", mandelCPU::kernelName(fallback.usedKernel()), fallback.threads());
+        initMandel();
+        emscripten_set_main_loop(fallbackLoop, 0, false);
+#else
+        printf("WebGPU device not available\n");
+#endif
+        return;
+    }
+    initWGPU();
+    initGraphics();
+
+    // Main loop
+    emscripten_set_main_loop([]() { mainLoop(); }, 0, false);
+}
+#endif
+
 // Main code
-int main(int, char**)
+int main(int argc, char** argv)
 {
+    for(int i = 1; i < argc; i++)
+        if(!strncmp(argv[i], "--interior=", 11)) shaderData.interior = atoi(argv[i] + 11);
+        else if(!strncmp(argv[i], "--escape=", 9)) wantedVariant.escapeRadius = std::max(2.f, float(atof(argv[i] + 9)));
+        else if(!strncmp(argv[i], "--unroll=", 9)) wantedVariant.unroll = std::max(1, atoi(argv[i] + 9));
+        else if(!strncmp(argv[i], "--power=", 8))  wantedVariant.power  = std::max(2, atoi(argv[i] + 8));
+        else if(!strcmp(argv[i], "--smooth"))      wantedVariant.smooth = true;
+        else if(!benchmark.parseArg(argv[i])) {
+            printf("usage: %s [options]\n"
+                   "  --interior=N            interior checks: 0 none, 1 cardioid/bulb, 2 periodicity, 3 both (default)\n"
+                   "  --escape=R              escape radius (default 4), keys E: 2 / 4 / 16 / 256\n"
+                   "  --unroll=N              iterations per bailout test (default 1), keys U: 1 / 2 / 4 / 8\n"
+                   "  --power=N               z^N + c (default 2), keys P: 2 .. 5\n"
+                   "  --smooth                smooth iteration count colouring, keys S: on / off\n%s", argv[0], zoomBenchmark::usage());
+            return -1;
+        }
+
     glfwSetErrorCallback([](int code, const char* message) { printf("GLFW Error %d: %s\n", code, message); });
     if (!glfwInit()) return -1;
 
@@ -469,26 +615,31 @@ int main(int, char**)
     fwWindow = glfwCreateWindow(initialWindowWidth, initialWindowHeight, appTitle, nullptr, nullptr);
     if (fwWindow == nullptr) return -2;
 
-    initWGPU();
-
-    glfwShowWindow(fwWindow);
-
-    initRenderPipeline();
-    initMandel();
+    glfwSetKeyCallback(fwWindow, [](GLFWwindow *, int key, int, int action, int) { if(action == GLFW_PRESS) switchVariant(tolower(key)); });
 
 #ifdef __EMSCRIPTEN__
-    // Main loop
-    emscripten_set_main_loop([]() { mainLoop(); }, 0, false);
+    // the device is requested, main() returns and onDeviceReady() goes on: keep the runtime alive
+    requestAdapterAndDeviceViaJS();
+    emscripten_runtime_keepalive_push();
+    return 0;
 #else
+    initWGPU();
+    initGraphics();
+
     // Main loop
     while (!glfwWindowShouldClose(fwWindow)) {
         mainLoop();
-        glfwPollEvents();   // Poll and handle events (inputs, window resize, etc.)
+        // idle or minimized: sleep until next event, otherwise poll and handle events (inputs, window resize, etc.)
+        // (not while a variant is built: its callback comes from device.Tick() of a drawn frame)
+        if((!pendingFrames && !variants.isBuilding()) || glfwGetWindowAttrib(fwWindow, GLFW_ICONIFIED) != 0) {
+            glfwWaitEvents();
+            requestRedraw();
+        } else glfwPollEvents();
     }
-#endif
 
     // All class destructors release the own object
     glfwDestroyWindow(fwWindow);
     glfwTerminate();
     return 0;
+#endif
 }
\ No newline at end of file
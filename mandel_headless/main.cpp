@@ -0,0 +1,613 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Headless (offscreen) Mandelbrot renderer: no window, no surface, no Present()
+//  The image is rendered tile by tile in a small offscreen texture and every tile
+//  is read back (MapAsync) and streamed to disk, so the output size is not limited
+//  by the max texture size and no full-size host buffer is needed (e.g. 32k x 32k)
+//------------------------------------------------------------------------------
+#define _FILE_OFFSET_BITS 64
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "mandelCPU.h"
+#include "tilePool.h"
+#include "zoomBenchmark.h"
+
+// Default App state
+static uint32_t imageWidth  {4096};
+static uint32_t imageHeight {4096};
+static uint32_t tileSize    {1024};
+static const char *outFileName {"mandelbrot.ppm"};
+static const char *adapterName {"default"};     // default | swiftshader | null
+static const char *cpuKernelName {nullptr};     // if set: render on CPU, no adapter/device at all
+static bool cpuBenchmark {false};               // compare all CPU kernels (speed and bit-exactness)
+static unsigned cpuThreads {0};                 // CPU workers, 0: all cores
+static const uint32_t cpuTileSize {64};         // work-stealing granularity
+static zoomBenchmark benchmark;                 // --benchmark: scripted zoom path on a --size offscreen frame
+
+// Mandelbrot data
+// I use the struct data position to simulate vec2f element used in the shader... and not to include an external library (e.g. GLM)
+struct alignas(16) shaderData_ {
+    float mScaleX = 1.5, mScaleY = 1.5;                               // pair used as vec2f in the shader
+    float mTranspX = -.75, mTranspY = 0.0;                            // pair used as vec2f in the shader
+    float wSizeX = 0, wSizeY = 0;                                     // pair used as vec2f in the shader
+    int32_t iterations = 256, nColors = 256;
+    float shift = 0.0;
+    int32_t interior = 3;       // interior checks of mandel.wgsl: 1 cardioid/bulb, 2 periodicity
+} shaderData;
+
+const char *shader  = {
+    #include "../mandel.wgsl"
+};
+
+// Offscreen tiles are always RGBA8: no surface, so no preferred format
+static const wgpu::TextureFormat tileFormat { wgpu::TextureFormat::RGBA8Unorm };
+static const uint32_t bytesPerPixel { 4 };
+static const uint32_t numReadbackSlots { 2 };   // tile N is rendered while tile N-1 is mapped
+
+// Global WebGPU required
+wgpu::Instance              instance;
+wgpu::Adapter               adapter;
+wgpu::Device                device;
+
+// Pipeline related objs
+wgpu::RenderPipeline pipeline;
+wgpu::Buffer ubo;
+wgpu::BindGroupLayout bindGroupLayout;
+wgpu::BindGroup bindGroup;
+
+// Offscreen related objs
+wgpu::Texture tileTexture;
+wgpu::TextureView tileView;
+uint32_t tileRowPitch;  // bytesPerRow of readback buffers (aligned to 256)
+
+struct readbackSlot {
+    wgpu::Buffer buffer;
+    wgpu::Future future;
+    bool inFlight = false;
+    bool mapped = false;    // set by the MapAsync callback
+    uint32_t x, y, w, h;    // destination rect in the full image
+} readbackSlots[numReadbackSlots];
+
+//------------------------------------------------------------------------------
+// Streaming image writer: binary PPM (P6) has a fixed size header, so any tile
+// can be written directly at its own file offset, in any order
+//------------------------------------------------------------------------------
+class tiledImageWriter {
+public:
+    ~tiledImageWriter() { close(); }
+
+    bool open(const char *fileName, uint32_t width, uint32_t height) {
+        file = fopen(fileName, "wb");
+        if(!file) return false;
+        w = width; h = height;
+        headerSize = fprintf(file, "P6\n%u %u\n255\n", w, h);
+        rowBuffer.resize(size_t(w) * 3);
+        return headerSize > 0;
+    }
+
+    void close() { if(file) fclose(file); file = nullptr; }
+
+    // rgba: tile pixels with rowPitch bytes per row (readback buffer layout)
+    bool writeTile(uint32_t x, uint32_t y, uint32_t tw, uint32_t th, const uint8_t *rgba, uint32_t rowPitch) {
+        for(uint32_t row = 0; row < th; row++) {
+            const uint8_t *src = rgba + size_t(row) * rowPitch;
+            uint8_t *dst = rowBuffer.data();
+            for(uint32_t col = 0; col < tw; col++, src += bytesPerPixel, dst += 3) {
+                dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2];
+            }
+            const int64_t offset = headerSize + (int64_t(y + row) * w + x) * 3;
+#if defined(_WIN32) || defined(WIN32)
+            if(_fseeki64(file, offset, SEEK_SET)) return false;
+#else
+            if(fseeko(file, off_t(offset), SEEK_SET)) return false;
+#endif
+            if(fwrite(rowBuffer.data(), 3, tw, file) != tw) return false;
+        }
+        return true;
+    }
+
+private:
+    FILE *file = nullptr;
+    uint32_t w = 0, h = 0;
+    int64_t headerSize = 0;
+    std::vector<uint8_t> rowBuffer;
+} imageWriter;
+
+// WGPU VL callbacks
+static void wgpu_device_lost_callback(const wgpu::Device&, wgpu::DeviceLostReason reason, wgpu::StringView message)
+{
+    const char* reasonName = "";
+    switch (reason) {
+        case wgpu::DeviceLostReason::Unknown:         reasonName = "Unknown";         break;
+        case wgpu::DeviceLostReason::Destroyed:       reasonName = "Destroyed";       break;
+        case wgpu::DeviceLostReason::CallbackCancelled: reasonName = "InstanceDropped"; break;
+        case wgpu::DeviceLostReason::FailedCreation:  reasonName = "FailedCreation";  break;
+        default:                                      reasonName = "UNREACHABLE";     break;
+    }
+    printf("%s device message: %s\n", reasonName, message.data);
+}
+
+static void wgpu_error_callback(const wgpu::Device&, wgpu::ErrorType type, wgpu::StringView message)
+{
+    const char* errorTypeName = "";
+    switch (type) {
+        case wgpu::ErrorType::Validation:  errorTypeName = "Validation";      break;
+        case wgpu::ErrorType::OutOfMemory: errorTypeName = "Out of memory";   break;
+        case wgpu::ErrorType::Unknown:     errorTypeName = "Unknown";         break;
+        case wgpu::ErrorType::Internal:    errorTypeName = "Internal";        break;
+        default:                           errorTypeName = "UNREACHABLE";     break;
+    }
+    printf("%s error: %s\n", errorTypeName, message.data);
+}
+
+bool initWGPU()
+{
+    wgpu::InstanceDescriptor instanceDescriptor;
+    instanceDescriptor.capabilities.timedWaitAnyEnable = true;
+    instance = wgpu::CreateInstance(&instanceDescriptor);
+
+    wgpu::RequestAdapterOptions adapterOptions;
+    adapterOptions.powerPreference = wgpu::PowerPreference::HighPerformance;
+    if(!strcmp(adapterName, "swiftshader")) {       // CPU Vulkan implementation (DAWN_ENABLE_SWIFTSHADER)
+        adapterOptions.backendType = wgpu::BackendType::Vulkan;
+        adapterOptions.forceFallbackAdapter = true;
+    } else if(!strcmp(adapterName, "null")) {       // no-op backend (DAWN_ENABLE_NULL): pipeline/throughput checks only
+        adapterOptions.backendType = wgpu::BackendType::Null;
+    }
+
+    auto onRequestAdapter = [](wgpu::RequestAdapterStatus status, wgpu::Adapter localAdapter, wgpu::StringView message) {
+        if (status != wgpu::RequestAdapterStatus::Success) {
+            printf("Failed to get an adapter: %s\n", message.data);
+            return;
+        }
+        adapter = std::move(localAdapter);
+    };
+
+    // Synchronously (wait until) acquire Adapter
+    auto waitedAdapterFunc { instance.RequestAdapter(&adapterOptions, wgpu::CallbackMode::WaitAnyOnly, onRequestAdapter) };
+    auto waitStatus = instance.WaitAny(waitedAdapterFunc, UINT64_MAX);
+    if(adapter == nullptr || waitStatus != wgpu::WaitStatus::Success) return false;
+
+    wgpu::AdapterInfo info;
+    adapter.GetInfo(&info);
+    printf("Using adapter: \" %s \"\n", info.device.data);
+    benchmark.setAdapter(info.device.data);
+
+    // Set device callback functions
+    wgpu::DeviceDescriptor deviceDesc;
+    deviceDesc.SetDeviceLostCallback(wgpu::CallbackMode::AllowSpontaneous, wgpu_device_lost_callback);
+    deviceDesc.SetUncapturedErrorCallback(wgpu_error_callback);
+
+    // get device Synchronously
+    device = adapter.CreateDevice(&deviceDesc);
+    return device != nullptr;
+}
+
+// Initialize render pipeline and offscreen objects
+void initRenderPipeline()
+{
+    wgpu::ShaderSourceWGSL wgslDesc;
+    wgslDesc.code = { shader, WGPU_STRLEN };
+    wgpu::ShaderModuleDescriptor shaderDescriptor;
+    shaderDescriptor.nextInChain = &wgslDesc;
+    wgpu::ShaderModule module = device.CreateShaderModule(&shaderDescriptor);
+
+    wgpu::RenderPipelineDescriptor descPipeline;
+    descPipeline.vertex.module = module;
+    descPipeline.vertex.bufferCount = 0;
+
+    // Set primitive state
+    descPipeline.primitive.topology         = wgpu::PrimitiveTopology::TriangleStrip;
+    descPipeline.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+    descPipeline.primitive.frontFace        = wgpu::FrontFace::CCW;
+    descPipeline.primitive.cullMode         = wgpu::CullMode::None;
+
+    // color target attribs: no blending, every pixel is overwritten
+    wgpu::ColorTargetState colorTarget {
+        .nextInChain = nullptr,
+        .format      = tileFormat,
+        .blend       = nullptr,
+        .writeMask   = wgpu::ColorWriteMask::All,
+    };
+
+    // Fragment Shader
+    wgpu::FragmentState fragment;
+    fragment.module = module;
+    fragment.targetCount = 1;
+    fragment.targets = &colorTarget;
+    descPipeline.fragment = &fragment;
+
+    // Uniform Buffer
+    wgpu::BufferDescriptor bufferDesc {
+        .nextInChain      = nullptr,
+        .label            = "uboData",
+        .usage            = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size             = sizeof(shaderData_),
+        .mappedAtCreation = false,
+    };
+    ubo = device.CreateBuffer(&bufferDesc);
+
+    // @group(0) @binding(0) var<uniform> shaderData
+    wgpu::BindGroupLayoutEntry bindGroupLayoutEntry;
+    bindGroupLayoutEntry.binding               = 0;
+    bindGroupLayoutEntry.visibility            = wgpu::ShaderStage::Fragment;
+    bindGroupLayoutEntry.buffer.type           = wgpu::BufferBindingType::Uniform;
+    bindGroupLayoutEntry.buffer.minBindingSize = sizeof(shaderData_);
+
+    wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+    bindGroupLayoutDesc.entryCount = 1;
+    bindGroupLayoutDesc.entries = &bindGroupLayoutEntry;
+    bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+    wgpu::PipelineLayoutDescriptor layoutDesc;
+    layoutDesc.bindGroupLayoutCount = 1;
+    layoutDesc.bindGroupLayouts = &bindGroupLayout;
+    descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+
+    pipeline = device.CreateRenderPipeline(&descPipeline);
+
+    // the UBO never changes buffer, only content: one BindGroup for all tiles
+    wgpu::BindGroupEntry entryBindingGroup {
+        .binding        = 0,
+        .buffer         = ubo,
+        .offset         = 0,
+        .size           = sizeof( shaderData_ ),
+    };
+    wgpu::BindGroupDescriptor descBindGroup {
+        .layout         = bindGroupLayout,
+        .entryCount     = 1,
+        .entries        = &entryBindingGroup,
+    };
+    bindGroup = device.CreateBindGroup(&descBindGroup);
+
+    // Offscreen tile texture: render target + copy source for readback
+    wgpu::TextureDescriptor descTexture;
+    descTexture.label     = "tileTexture";
+    descTexture.usage     = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::CopySrc;
+    descTexture.dimension = wgpu::TextureDimension::e2D;
+    descTexture.size      = { tileSize, tileSize, 1 };
+    descTexture.format    = tileFormat;
+    tileTexture = device.CreateTexture(&descTexture);
+    tileView    = tileTexture.CreateView();
+
+    // Readback buffers: bytesPerRow must be a multiple of 256
+    tileRowPitch = (tileSize * bytesPerPixel + 255) & ~255u;
+    wgpu::BufferDescriptor descReadback {
+        .label            = "tileReadback",
+        .usage            = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+        .size             = uint64_t(tileRowPitch) * tileSize,
+        .mappedAtCreation = false,
+    };
+    for(auto &slot : readbackSlots) slot.buffer = device.CreateBuffer(&descReadback);
+}
+
+// Wait the mapped tile, stream it to the image writer and release the slot
+bool flushSlot(readbackSlot &slot)
+{
+    if(!slot.inFlight) return true;
+    const wgpu::WaitStatus waitStatus = instance.WaitAny(slot.future, UINT64_MAX);
+    slot.inFlight = false;
+    if(waitStatus != wgpu::WaitStatus::Success) { printf("Tile readback wait failed (status %d)\n", int(waitStatus)); return false; }
+    if(!slot.mapped) return false;  // map failed: reported by its callback, the buffer is not readable
+    slot.mapped = false;
+
+    const uint8_t *data = (const uint8_t *) slot.buffer.GetConstMappedRange(0, uint64_t(tileRowPitch) * tileSize);
+    bool ok = data && imageWriter.writeTile(slot.x, slot.y, slot.w, slot.h, data, tileRowPitch);
+    slot.buffer.Unmap();
+    return ok;
+}
+
+// Render the tile (x, y, w, h) of the full image in the offscreen texture and start its readback
+void renderTile(readbackSlot &slot, uint32_t x, uint32_t y, uint32_t w, uint32_t h, const shaderData_ &view)
+{
+    // sub-view of the tile: same c = mTransp - mScale + pos/wSize * 2*mScale of the full image,
+    // with pos relative to the tile (the tile texture has always tileSize x tileSize pixels)
+    shaderData_ tileData = view;
+    tileData.wSizeX   = float(tileSize);
+    tileData.wSizeY   = float(tileSize);
+    tileData.mScaleX  = view.mScaleX * float(tileSize) / view.wSizeX;
+    tileData.mScaleY  = view.mScaleY * float(tileSize) / view.wSizeY;
+    tileData.mTranspX = view.mTranspX - view.mScaleX + (2.f * float(x) + float(tileSize)) / view.wSizeX * view.mScaleX;
+    tileData.mTranspY = view.mTranspY - view.mScaleY + (2.f * float(y) + float(tileSize)) / view.wSizeY * view.mScaleY;
+    device.GetQueue().WriteBuffer( ubo, 0, &tileData, sizeof( shaderData_ ) );
+
+    wgpu::RenderPassColorAttachment colorAttachments {
+        .view            = tileView,
+        .depthSlice      = wgpu::kDepthSliceUndefined,
+        .loadOp          = wgpu::LoadOp::Clear,
+        .storeOp         = wgpu::StoreOp::Store,
+        .clearValue      = {},
+    };
+    wgpu::RenderPassDescriptor descRenderPass {
+        .label                  = "tileRenderPassDescriptor",
+        .colorAttachmentCount   = 1,
+        .colorAttachments       = &colorAttachments,
+    };
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&descRenderPass);
+    pass.SetPipeline(pipeline);
+    pass.SetBindGroup(0, bindGroup, 0, nullptr );
+    pass.Draw(4, 1, 0, 0);
+    pass.End();
+
+    // copy only the valid part of the tile (border tiles can be smaller)
+    wgpu::TexelCopyTextureInfo copySrc { .texture = tileTexture };
+    wgpu::TexelCopyBufferInfo  copyDst {
+        .layout = { .offset = 0, .bytesPerRow = tileRowPitch, .rowsPerImage = tileSize },
+        .buffer = slot.buffer,
+    };
+    wgpu::Extent3D copySize { w, h, 1 };
+    encoder.CopyTextureToBuffer(&copySrc, &copyDst, &copySize);
+
+    wgpu::CommandBuffer cmd_buffer = encoder.Finish();
+    device.GetQueue().Submit(1, &cmd_buffer);
+
+    slot.x = x; slot.y = y; slot.w = w; slot.h = h;
+    slot.mapped = false;
+    slot.future = slot.buffer.MapAsync(wgpu::MapMode::Read, 0, uint64_t(tileRowPitch) * tileSize, wgpu::CallbackMode::WaitAnyOnly,
+                                       [](wgpu::MapAsyncStatus status, wgpu::StringView message, readbackSlot *slot) {
+                                           slot->mapped = status == wgpu::MapAsyncStatus::Success;
+                                           if(!slot->mapped) printf("Tile readback failed: %s\n", message.data);
+                                       }, &slot);
+    slot.inFlight = true;
+}
+
+// full image view: keep the aspect-ratio of the image (same rule of appResizeArea)
+static shaderData_ posterView()
+{
+    shaderData_ view = shaderData;
+    view.mScaleX = shaderData.mScaleY * float(imageWidth) / float(imageHeight);
+    view.wSizeX  = float(imageWidth);
+    view.wSizeY  = float(imageHeight);
+    return view;
+}
+
+bool renderPoster()
+{
+    if(!imageWriter.open(outFileName, imageWidth, imageHeight)) {
+        printf("Unable to create output file: %s\n", outFileName);
+        return false;
+    }
+
+    const shaderData_ view = posterView();
+
+    const uint32_t tilesX = (imageWidth  + tileSize - 1) / tileSize;
+    const uint32_t tilesY = (imageHeight + tileSize - 1) / tileSize;
+    uint32_t tileCount = 0;
+    bool ok = true;
+    for(uint32_t ty = 0; ty < tilesY && ok; ty++)
+        for(uint32_t tx = 0; tx < tilesX && ok; tx++, tileCount++) {
+            readbackSlot &slot = readbackSlots[tileCount % numReadbackSlots];
+            // free the slot: stream out the tile rendered numReadbackSlots steps ago
+            if(!(ok = flushSlot(slot))) break;
+
+            const uint32_t x = tx * tileSize, y = ty * tileSize;
+            renderTile(slot, x, y, std::min(tileSize, imageWidth - x), std::min(tileSize, imageHeight - y), view);
+        }
+    for(auto &slot : readbackSlots) ok &= flushSlot(slot);
+
+    imageWriter.close();
+    printf("%s: %ux%u pixels, %u tiles of %ux%u\n", outFileName, imageWidth, imageHeight, tileCount, tileSize, tileSize);
+    return ok;
+}
+
+// GPU-less fallback: same tiles, rendered by the CPU reference engine
+bool renderPosterCPU()
+{
+    if(!imageWriter.open(outFileName, imageWidth, imageHeight)) {
+        printf("Unable to create output file: %s\n", outFileName);
+        return false;
+    }
+
+    const mandelCPU::params view = mandelCPU::fromShaderData(posterView());
+    const mandelCPU::kernel kernel = mandelCPU::kernelFromName(cpuKernelName);
+    std::vector<int32_t> iter(size_t(tileSize) * tileSize);
+    std::vector<uint8_t> rgba(iter.size() * bytesPerPixel);
+    tilePool pool(cpuThreads);
+
+    mandelCPU::stats total { mandelCPU::isSupported(kernel) && kernel != mandelCPU::kernel::Auto ? kernel : mandelCPU::bestKernel(), 0, 0, 0 };
+    bool ok = true;
+    for(uint32_t y = 0; y < imageHeight && ok; y += tileSize)
+        for(uint32_t x = 0; x < imageWidth && ok; x += tileSize) {
+            const uint32_t w = std::min(tileSize, imageWidth - x), h = std::min(tileSize, imageHeight - y);
+            auto start = std::chrono::steady_clock::now();
+            total.iterations += mandelCPU::renderRectTiled(pool, total.usedKernel, view, x, y, w, h, iter.data(), w, cpuTileSize);
+            total.seconds    += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            total.pixels     += uint64_t(w) * h;
+
+            mandelCPU::colorize(view, iter.data(), size_t(w) * h, rgba.data());
+            ok = imageWriter.writeTile(x, y, w, h, rgba.data(), w * bytesPerPixel);
+        }
+
+    imageWriter.close();
+    printf("%s: %ux%u pixels, CPU kernel %s x %u threads: %.1f Mpixel/s, %.3f Giga-iterations/s\n", outFileName, imageWidth, imageHeight,
+           mandelCPU::kernelName(total.usedKernel), pool.size(), total.mPixelsPerSec(), total.gIterPerSec());
+    return ok;
+}
+
+// Run every supported CPU kernel on the same view: throughput and bit-exactness against the scalar kernel
+bool benchmarkCPU()
+{
+    const mandelCPU::params view = mandelCPU::fromShaderData(posterView());
+    std::vector<int32_t> reference, iter;
+    bool ok = true;
+    for(int k = int(mandelCPU::kernel::Scalar); k < int(mandelCPU::kernel::Count); k++) {
+        const mandelCPU::kernel kernel = mandelCPU::kernel(k);
+        if(!mandelCPU::isSupported(kernel)) { printf("%-8s not supported\n", mandelCPU::kernelName(kernel)); continue; }
+
+        mandelCPU::stats s = mandelCPU::render(kernel, view, kernel == mandelCPU::kernel::Scalar ? reference : iter);
+        const bool same = kernel == mandelCPU::kernel::Scalar || iter == reference;
+        ok &= same;
+        printf("%-8s %9.2f Mpixel/s %8.3f Giga-iterations/s  %s\n", mandelCPU::kernelName(kernel),
+               s.mPixelsPerSec(), s.gIterPerSec(), same ? "bit-exact" : "MISMATCH");
+    }
+
+    // multicore scaling of the best kernel
+    const mandelCPU::kernel best = mandelCPU::bestKernel();
+    const mandelCPU::stats single = mandelCPU::render(best, view, iter);
+    tilePool pool(cpuThreads);
+    const mandelCPU::stats multi = mandelCPU::renderTiled(pool, best, view, iter, cpuTileSize);
+    ok &= iter == reference;
+    printf("%s x %u threads: %9.2f Mpixel/s %8.3f Giga-iterations/s  speedup %.2fx (efficiency %.0f%%)  %s\n",
+           mandelCPU::kernelName(best), pool.size(), multi.mPixelsPerSec(), multi.gIterPerSec(),
+           single.seconds / multi.seconds, 100. * single.seconds / multi.seconds / pool.size(), iter == reference ? "bit-exact" : "MISMATCH");
+    for(unsigned i = 0; i < pool.size(); i++) {
+        const tilePool::workerStats &ws = pool.stats(i);
+        printf("  thread %3u: %6llu tiles, %6llu steals, %6llu failed steals, busy %5.1f%%\n", i, (unsigned long long) ws.tiles,
+               (unsigned long long) ws.steals, (unsigned long long) ws.failedSteals, 100. * ws.busySeconds / pool.lastRunSeconds());
+    }
+    return ok;
+}
+
+// Scripted zoom path (zoomBenchmark) on an offscreen frame of --size: no Present, so every
+// frame waits its submitted work (GPU time of the frame, e.g. --adapter=swiftshader)
+bool benchmarkGPU()
+{
+    wgpu::TextureDescriptor descTexture;
+    descTexture.label     = "benchmarkFrame";
+    descTexture.usage     = wgpu::TextureUsage::RenderAttachment;
+    descTexture.dimension = wgpu::TextureDimension::e2D;
+    descTexture.size      = { imageWidth, imageHeight, 1 };
+    descTexture.format    = tileFormat;
+    wgpu::TextureView frameView = device.CreateTexture(&descTexture).CreateView();
+
+    wgpu::RenderPassColorAttachment colorAttachments {
+        .view            = frameView,
+        .depthSlice      = wgpu::kDepthSliceUndefined,
+        .loadOp          = wgpu::LoadOp::Clear,
+        .storeOp         = wgpu::StoreOp::Store,
+        .clearValue      = {},
+    };
+    wgpu::RenderPassDescriptor descRenderPass {
+        .label                  = "benchmarkRenderPassDescriptor",
+        .colorAttachmentCount   = 1,
+        .colorAttachments       = &colorAttachments,
+    };
+
+    benchmark.addInfo("interior", shaderData.interior);
+    benchmark.start("mandel_headless");
+    while(benchmark.isRunning()) {
+        // same aspect-ratio rule of posterView()
+        const zoomBenchmark::keyframe v = benchmark.currentView();
+        shaderData_ view = shaderData;
+        view.mTranspX   = float(v.cx);
+        view.mTranspY   = float(v.cy);
+        view.mScaleY    = float(v.scale);
+        view.mScaleX    = float(v.scale * double(imageWidth) / double(imageHeight));
+        view.wSizeX     = float(imageWidth);
+        view.wSizeY     = float(imageHeight);
+        view.iterations = v.iterations;
+        device.GetQueue().WriteBuffer( ubo, 0, &view, sizeof( shaderData_ ) );
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&descRenderPass);
+        pass.SetPipeline(pipeline);
+        pass.SetBindGroup(0, bindGroup, 0, nullptr );
+        pass.Draw(4, 1, 0, 0);
+        pass.End();
+        wgpu::CommandBuffer cmd_buffer = encoder.Finish();
+        device.GetQueue().Submit(1, &cmd_buffer);
+
+        wgpu::Future done = device.GetQueue().OnSubmittedWorkDone(wgpu::CallbackMode::WaitAnyOnly, [](wgpu::QueueWorkDoneStatus, wgpu::StringView) {});
+        if(instance.WaitAny(done, UINT64_MAX) != wgpu::WaitStatus::Success) return false;
+        benchmark.frameDone(imageWidth, imageHeight);
+    }
+    return true;
+}
+
+static void printUsage(const char *appName)
+{
+    printf("usage: %s [options]\n"
+           "  --size=WxH              output image size        (default %ux%u)\n"
+           "  --tile=N                tile size in pixels      (default %u)\n"
+           "  --out=file.ppm          output file              (default %s)\n"
+           "  --adapter=NAME          default | swiftshader | null\n"
+           "  --center=X,Y            view center              (default %g,%g)\n"
+           "  --scale=S               half height of the view  (default %g)\n"
+           "  --iterations=N --colors=N --shift=F\n"
+           "  --interior=N            interior checks: 0 none, 1 cardioid/bulb, 2 periodicity, 3 both (default)\n"
+           "  --cpu=KERNEL            render on CPU: auto | scalar | sse4.2 | avx2 | avx512\n"
+           "  --cpu-bench             compare all supported CPU kernels on the --size view\n"
+           "  --threads=N             CPU worker threads       (default 0: all cores)\n"
+           "%s",
+           appName, imageWidth, imageHeight, tileSize, outFileName, shaderData.mTranspX, shaderData.mTranspY, shaderData.mScaleY,
+           zoomBenchmark::usage());
+}
+
+static bool parseArgs(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        auto isOpt = [&](const char *opt) { size_t len = strlen(opt); return !strncmp(arg, opt, len) ? arg + len : nullptr; };
+        const char *val;
+        if     ((val = isOpt("--size=")))       { if(sscanf(val, "%ux%u", &imageWidth, &imageHeight) != 2) return false; }
+        else if((val = isOpt("--tile=")))       { const int n = atoi(val); if(n <= 0) return false; tileSize = uint32_t(n); }
+        else if((val = isOpt("--out=")))        outFileName = val;
+        else if((val = isOpt("--adapter=")))    adapterName = val;
+        else if((val = isOpt("--center=")))     { if(sscanf(val, "%f,%f", &shaderData.mTranspX, &shaderData.mTranspY) != 2) return false; }
+        else if((val = isOpt("--scale=")))      shaderData.mScaleX = shaderData.mScaleY = float(atof(val));
+        else if((val = isOpt("--iterations="))) shaderData.iterations = atoi(val);
+        else if((val = isOpt("--colors=")))     shaderData.nColors = atoi(val);
+        else if((val = isOpt("--shift=")))      shaderData.shift = float(atof(val));
+        else if((val = isOpt("--interior=")))   shaderData.interior = atoi(val);
+        else if((val = isOpt("--cpu=")))        {
+            if(mandelCPU::kernelFromName(val) == mandelCPU::kernel::Count) { printf("unknown CPU kernel: %s\n", val); return false; }
+            cpuKernelName = val;
+        }
+        else if(!strcmp(arg, "--cpu-bench"))    cpuBenchmark = true;
+        else if((val = isOpt("--threads=")))    cpuThreads = unsigned(atoi(val));
+        else if(benchmark.parseArg(arg))        continue;
+        else return false;
+    }
+    return imageWidth > 0 && imageHeight > 0 && tileSize >= 16;
+}
+
+// Main code
+int main(int argc, char** argv)
+{
+    if(!parseArgs(argc, argv)) { printUsage(argv[0]); return -1; }
+
+    if(cpuBenchmark)  return benchmarkCPU()    ? 0 : -3;
+    if(cpuKernelName) return renderPosterCPU() ? 0 : -3;
+
+    if(!initWGPU()) { printf("Error creating Adapter/Device (adapter: %s)\n", adapterName); return -2; }
+
+    // tile can't exceed the device limits
+    wgpu::Limits limits;
+    device.GetLimits(&limits);
+    tileSize = std::min(tileSize, limits.maxTextureDimension2D);
+
+    initRenderPipeline();
+
+    if(benchmark.isRequested()) {
+        if(imageWidth > limits.maxTextureDimension2D || imageHeight > limits.maxTextureDimension2D) {
+            printf("benchmark frame %ux%u exceeds max texture size %u\n", imageWidth, imageHeight, limits.maxTextureDimension2D);
+            return -1;
+        }
+        return benchmarkGPU() ? 0 : -3;
+    }
+
+    return renderPoster() ? 0 : -3;
+
+    // All WGPU class destructors release the own object
+}
@@ -12,13 +12,29 @@
 //------------------------------------------------------------------------------
 #include <cstdio>
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
 
 #include "imgui.h"
 #include "imgui_impl_sdl2.h"
 #include "imgui_impl_wgpu.h"
 
+#include "mandelPerturb.h"
+#include "mandelCompute.h"
+#include "palette.h"
+#include "tileCache.h"
+#include "blobCache.h"
+#include "startupReport.h"
+#include "gpuTimer.h"
+#include "renderScale.h"
+#include "cpuProfiler.h"
+#include "zoomBenchmark.h"
+
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#include <emscripten/eventloop.h>
 #include <emscripten/html5.h>
 #include <emscripten/html5_webgpu.h>
 #endif
@@ -40,42 +56,94 @@ struct alignas(16) shaderData_ {
     float wSizeX = initialWindowWidth, wSizeY = initialWindowHeight;
     int32_t iterations = 256, nColors = 256;
     float shift = 0.0;
+    int32_t interior = 3;                                             // interior checks: 1 cardioid/bulb, 2 periodicity (mandel.wgsl)
+    float mScaleLoX = 0, mScaleLoY = 0;                               // df64 low parts of mScale  (mandel_df64.wgsl only)
+    float mTranspLoX = 0, mTranspLoY = 0;                             // df64 low parts of mTransp (mandel_df64.wgsl only)
+    float one = 1;                                                    // runtime 1: df64 products out of FMA contraction (mandel_df64.wgsl only)
 } shaderData;
 const float zoomFactor = .05;
 
-const char *shader  = {
-    #include "../mandel.wgsl"
-};
+// Deep zoom: high precision view (shaderData mTransp/mScale follow it) and perturbation renderer
+mandelPerturb perturb;
+enum renderModes { renderAuto, renderF32, renderDF64, renderPerturbation };
+int renderMode = renderAuto;   // renderAuto: cheapest precision that resolves the pixel size
+
+// Iteration texture (compute) + colorize: iterations run again only when iterationDirty
+mandelCompute mandel;
+bool iterationDirty = true;    // view, iterations or precision changed
+// Palette LUT of colorize: gradient editor in renderImGui(), uploaded only on edit
+palette colors;
+// Tile cache pyramid (f32): revisited regions / zoom within a level composite cached tiles
+tileCache tiles;
+bool useTileCache = false;
+tileStore diskTiles;            // --tile-store=file: tiles of the cache kept on disk across runs
+
+// Cold start: DAWN blob cache (compiled shaders, backend pipelines) on disk, time to first frame
+blobCache     pipelineCache;
+const char   *blobCacheDir = "mandel_blob_cache";   // --blob-cache=DIR, empty: disabled
+startupReport startup;
+bool          printStartup = false;                 // --startup-report
+
+// GPU time of the passes (if TimestampQuery is available)
+enum gpuPasses { gpuIterate, gpuColorize, gpuImGui, gpuPassCount };
+gpuTimer gpuTime;
+// Adaptive render scale (--render-scale=MS): iteration grid below surface size while the view changes
+renderScale adaptiveScale;
+uint64_t    iterateSamples = 0;         // gpuTime samples of gpuIterate already seen
+
+// CPU time of the frame stages: histogram of frame time, F12 (or --trace N at exit) writes last N seconds as Chrome trace
+cpuProfiler profiler;
+double traceSeconds = 10;
+const char *traceFile = "mandel_trace.json";
 
 // Global WebGPU required
 wgpu::Instance              instance;
+wgpu::Adapter               adapter;
 wgpu::Device                device;
 wgpu::Surface               surface;
 wgpu::TextureFormat         preferredFormat { wgpu::TextureFormat::Undefined };  // current undefined, but set from SurfaceCapabilities
 wgpu::SurfaceConfiguration  surfaceConfig;
 
 // Pipeline related objs
-wgpu::RenderPipeline pipeline;
 wgpu::Buffer ubo;
-wgpu::BindGroupLayout bindGroupLayout;
+
+// Scripted zoom path (--benchmark): replaces the mouse, presentation uncapped
+zoomBenchmark benchmark;
 
 // Forward declarations
 static void updateUniformBuffer();
 
+// Render on demand: frames still to draw, when 0 mainLoop() does nothing and the loop waits for events
+// (2: ImGui needs a frame more to settle hovered / active items after an input)
+int pendingFrames = 2;
+void requestRedraw(int frames = 2) { if(pendingFrames < frames) pendingFrames = frames; }
+
 // GLFW main framework window
 SDL_Window* fwWindow;
 
 // Mandelbrot implementation functions
+// f32 view of shaderData from the high precision one
+void syncShaderData()
+{
+    // hi + lo parts for df64: the double of the high precision view is enough (53 bits)
+    auto splitDF64 = [](double v, float &hi, float &lo) { hi = float(v); lo = float(v - double(hi)); };
+    splitDF64(perturb.scaleX().toDouble(), shaderData.mScaleX,  shaderData.mScaleLoX);
+    splitDF64(perturb.scaleY().toDouble(), shaderData.mScaleY,  shaderData.mScaleLoY);
+    splitDF64(perturb.centerX(),           shaderData.mTranspX, shaderData.mTranspLoX);
+    splitDF64(perturb.centerY(),           shaderData.mTranspY, shaderData.mTranspLoY);
+}
+
 void zoom(float scale) // Mandel Zoom func
 {
     int x, y; SDL_GetMouseState(&x, &y);
     int w, h; SDL_GetWindowSize(fwWindow, &w, &h);
 
-    shaderData.mScaleX  *=  float(1.0)+scale;
-    shaderData.mScaleY  *=  float(1.0)+scale;
-    shaderData.mTranspX += (float(w)*float(.5) - float(x))/(float(w)*float(.5)) * scale * shaderData.mScaleX;
-    shaderData.mTranspY += (float(h)*float(.5) - float(y))/(float(h)*float(.5)) * scale * shaderData.mScaleY;
+    const double offX = (double(w)*.5 - double(x))/(double(w)*.5), offY = (double(h)*.5 - double(y))/(double(h)*.5);
+    perturb.zoom(offX, offY, scale);
+    syncShaderData();
     updateUniformBuffer();
+    mandel.zoom(offX, offY, scale);     // reuse previous pixels: only inexact ones iterate again
+    iterationDirty = true;
 }
 
 void checkMouseButtonAction()
@@ -90,11 +158,35 @@ void checkMouseButtonAction()
 
 void appResizeArea(const  uint32_t w, const uint32_t h) // re-adjust aspect-ratio
 {
-    static int width = w, height = h;
-    shaderData.mScaleY+=float(h-float(height)) * shaderData.mScaleY/float(height);
-    shaderData.mScaleX+=float(w-float(width))  * shaderData.mScaleX/float(width) ;
-    shaderData.wSizeX = width = w; shaderData.wSizeY = height = h;
+    perturb.resize(w, h);
+    syncShaderData();
+    shaderData.wSizeX = w; shaderData.wSizeY = h;
     updateUniformBuffer();
+    mandel.invalidate();      // new view: pixel states restart from z = 0
+    iterationDirty = true;
+}
+
+// iteration grid: surface size * render scale (colorize upscales it), same view
+// (center and half size kept: appResizeArea() is only for surface resizes)
+void resizeIterationGrid()
+{
+    const uint32_t w = adaptiveScale.scaled(surfaceConfig.width), h = adaptiveScale.scaled(surfaceConfig.height);
+    if(w == mandel.width() && h == mandel.height()) return;
+    mandel.resize(w, h);
+    perturb.setGrid(w, h);    // reference orbit kept: no new one in deep zoom
+    shaderData.wSizeX = w; shaderData.wSizeY = h;
+    updateUniformBuffer();
+    mandel.invalidate();
+    iterationDirty = true;
+}
+
+// every drawn frame: new GPU ms of the iterations (timed frames that iterate) while the view changes
+void updateRenderScale()
+{
+    const uint64_t samples = gpuTime.sampleCount(gpuIterate);
+    const float ms = samples != iterateSamples ? gpuTime.lastSample(gpuIterate) : -1.f;
+    iterateSamples = samples;
+    if(adaptiveScale.update(ms, iterationDirty)) resizeIterationGrid();
 }
 
 void initMandel()
@@ -104,12 +196,38 @@ void initMandel()
     int w, h;
     SDL_GetWindowSize(fwWindow, &w, &h);
     uint32_t size = std::min(w, h);
+    perturb.setView(shaderData.mTranspX, shaderData.mTranspY, shaderData.mScaleX, shaderData.mScaleY, size, size);
     appResizeArea(size, size);
 #else
+    perturb.setView(shaderData.mTranspX, shaderData.mTranspY, shaderData.mScaleX, shaderData.mScaleY, surfaceConfig.width, surfaceConfig.height);
     appResizeArea(surfaceConfig.width, surfaceConfig.height);
 #endif
 }
 
+// benchmark: view of current frame (aspect-ratio of the window, as appResizeArea)
+void benchmarkView()
+{
+    const zoomBenchmark::keyframe v = benchmark.currentView();
+    const uint32_t w = perturb.width(), h = perturb.height();
+    perturb.setView(v.cx, v.cy, v.scale * double(w) / double(h), v.scale, w, h);
+    shaderData.iterations = v.iterations;
+    syncShaderData();
+    updateUniformBuffer();
+    mandel.invalidate();      // every frame from z = 0: compares shader cost, not reprojection reuse
+    iterationDirty = true;
+}
+
+// after Present: path completed, report written -> quit
+void benchmarkFrameDone()
+{
+    if(!benchmark.isRunning() || !benchmark.frameDone(surfaceConfig.width, surfaceConfig.height)) return;
+#if defined(__EMSCRIPTEN__)
+    emscripten_cancel_main_loop();
+#else
+    SDL_Event quit {}; quit.type = SDL_QUIT; SDL_PushEvent(&quit);
+#endif
+}
+
 // WGPU VL callbacks
 #if !defined(__EMSCRIPTEN__)
 static void wgpu_device_lost_callback(const wgpu::Device&, wgpu::DeviceLostReason reason, wgpu::StringView message)
@@ -138,13 +256,66 @@ static void wgpu_error_callback(const wgpu::Device&, wgpu::ErrorType type, wgpu:
     printf("%s error: %s\n", errorTypeName, message.data);
 }
 
-void initWGPU()
+// Adapter and device requested on a worker thread while main() creates the window and the ImGui
+// context / font atlas: the worker blocks in WaitAny on each request, the main thread keeps working
+static void onDevice(wgpu::RequestDeviceStatus status, wgpu::Device result, wgpu::StringView message)
+{
+    if(status != wgpu::RequestDeviceStatus::Success) printf("Failed to get a device: %s\n", message.data);
+    else { device = std::move(result); startup.mark("device"); }
+}
+
+static void onAdapter(wgpu::RequestAdapterStatus status, wgpu::Adapter result, wgpu::StringView message)
+{
+    if(status != wgpu::RequestAdapterStatus::Success) printf("Failed to get an adapter: %s\n", message.data);
+    else adapter = std::move(result);
+}
+
+// device of the adapter: descriptor from its info, features and limits
+static wgpu::Future requestDeviceOfAdapter()
+{
+    wgpu::AdapterInfo info;
+    adapter.GetInfo(&info);
+    startup.mark("adapter");
+    benchmark.setAdapter(info.device.data);
+#ifndef NDEBUG
+    printf("Using adapter: \" %s \"\n", info.device.data);
+#endif
+
+    // Set device callback functions
+    wgpu::DeviceDescriptor deviceDesc;
+    deviceDesc.SetDeviceLostCallback(wgpu::CallbackMode::AllowSpontaneous, wgpu_device_lost_callback);
+    deviceDesc.SetUncapturedErrorCallback(wgpu_error_callback);
+    // pass timings (gpuTimer): only if the adapter supports them
+    const wgpu::FeatureName timestampFeature = wgpu::FeatureName::TimestampQuery;
+    if(adapter.HasFeature(timestampFeature)) {
+        deviceDesc.requiredFeatureCount = 1;
+        deviceDesc.requiredFeatures     = &timestampFeature;
+    }
+    // pixel states of mandelCompute (32 bytes per pixel): the largest buffers the adapter allows, not the defaults
+    wgpu::Limits adapterLimits, requiredLimits;
+    if(adapter.GetLimits(&adapterLimits) == wgpu::Status::Success) {
+        requiredLimits.maxStorageBufferBindingSize = adapterLimits.maxStorageBufferBindingSize;
+        requiredLimits.maxBufferSize               = adapterLimits.maxBufferSize;
+        deviceDesc.requiredLimits = &requiredLimits;
+    }
+
+    // shaders and pipelines from a previous run: the cache is kept apart per adapter / driver
+    if(pipelineCache.open(blobCacheDir))
+        pipelineCache.attach(deviceDesc, std::string(info.vendor.data) + "|" + info.device.data + "|" + info.description.data + "|" +
+                                         std::to_string(int(info.backendType)));
+
+    return adapter.RequestDevice(&deviceDesc, wgpu::CallbackMode::WaitAnyOnly, onDevice);
+}
+
+// worker thread: returns with device set, or null on failure
+void requestDevice()
 {
+    CPU_ZONE(profiler, "startup: adapter + device");
     wgpu::InstanceDescriptor instanceDescriptor;
     instanceDescriptor.capabilities.timedWaitAnyEnable = true;
     instance = wgpu::CreateInstance(&instanceDescriptor);
+    startup.mark("instance");
 
-    static wgpu::Adapter localAdapter;
     wgpu::RequestAdapterOptions adapterOptions;
 
     // uncomment to force backend Vulkan (e.g. instead of Metal on MacOS)
@@ -155,40 +326,28 @@ void initWGPU()
     // adapterOptions.backendType = wgpu::BackendType::D3D11; // to use D3D11 backend in W10/W11
 #endif
 
-    auto onRequestAdapter = [](wgpu::RequestAdapterStatus status, wgpu::Adapter adapter, wgpu::StringView message) {
-        if (status != wgpu::RequestAdapterStatus::Success) {
-            printf("Failed to get an adapter: %s\n", message.data);
-            return;
-        }
-        localAdapter = std::move(adapter);
-    };
-
-    // Synchronously (wait until) acquire Adapter
-    auto waitedAdapterFunc { instance.RequestAdapter(&adapterOptions, wgpu::CallbackMode::WaitAnyOnly, onRequestAdapter) };
-    auto waitStatus = instance.WaitAny(waitedAdapterFunc, UINT64_MAX);
-    assert(localAdapter != nullptr && waitStatus == wgpu::WaitStatus::Success && "Error on Adapter request");
-
-#ifndef NDEBUG
-    wgpu::AdapterInfo info;
-    localAdapter.GetInfo(&info);
-    printf("Using adapter: \" %s \"\n", info.device.data);
-#endif
-
-    // Set device callback functions
-    wgpu::DeviceDescriptor deviceDesc;
-    deviceDesc.SetDeviceLostCallback(wgpu::CallbackMode::AllowSpontaneous, wgpu_device_lost_callback);
-    deviceDesc.SetUncapturedErrorCallback(wgpu_error_callback);
+    // blocking waits: this thread sleeps until each request completes (no polling)
+    auto waitedAdapterFunc { instance.RequestAdapter(&adapterOptions, wgpu::CallbackMode::WaitAnyOnly, onAdapter) };
+    if(instance.WaitAny(waitedAdapterFunc, UINT64_MAX) != wgpu::WaitStatus::Success) {
+        printf("Waiting for the adapter failed\n");
+        return;
+    }
+    if(!adapter) return;
 
-    // get device Synchronously
-    device = localAdapter.CreateDevice(&deviceDesc);
-    assert(device != nullptr && "Error creating the Device");
+    auto waitedDeviceFunc { requestDeviceOfAdapter() };
+    if(instance.WaitAny(waitedDeviceFunc, UINT64_MAX) != wgpu::WaitStatus::Success) printf("Waiting for the device failed\n");
+}
 
+// main thread, after requestDevice() and the window: surface of the window
+void initSurface()
+{
+    CPU_ZONE(profiler, "startup: surface");
     surface = wgpu::Surface(SDL_getWGPUSurface(instance.Get(), fwWindow));
     assert(surface != nullptr && "Error creating the Surface");
 
     // Configure the surface.
     wgpu::SurfaceCapabilities capabilities;
-    surface.GetCapabilities(localAdapter, &capabilities);
+    surface.GetCapabilities(adapter, &capabilities);
     preferredFormat = capabilities.formats[0];
 
     surfaceConfig.device          = device;
@@ -198,27 +357,49 @@ void initWGPU()
     surfaceConfig.height          = initialWindowHeight;
     surfaceConfig.alphaMode       = wgpu::CompositeAlphaMode::Auto;
     surfaceConfig.presentMode     = wgpu::PresentMode::Fifo;
+    // benchmark: don't wait vsync (Immediate, otherwise Mailbox) if available
+    if(benchmark.isRequested())
+        for(size_t i = 0; i < capabilities.presentModeCount; i++)
+            if(capabilities.presentModes[i] == wgpu::PresentMode::Immediate ||
+              (capabilities.presentModes[i] == wgpu::PresentMode::Mailbox && surfaceConfig.presentMode == wgpu::PresentMode::Fifo))
+                surfaceConfig.presentMode = capabilities.presentModes[i];
 
     surface.Configure(&surfaceConfig);
+    startup.mark("surface");
 }
 #else
-// Adapter and device initialization via JS
-EM_ASYNC_JS( void, getAdapterAndDeviceViaJS, (),
+// Adapter and device requested via JS promises (timestamp-query for gpuTimer, if supported): no ASYNCIFY, the call returns at once
+// and onDeviceReady() continues the startup (main loop started only with a device)
+EM_JS( void, requestAdapterAndDeviceViaJS, (),
 {
-    if (!navigator.gpu) throw Error("WebGPU not supported.");
-
-    const adapter = await navigator.gpu.requestAdapter();
-    const device = await adapter.requestDevice();
-    Module.preinitializedWebGPUDevice = device;
+    // always asynchronous, also without navigator.gpu: onDeviceReady() runs after main() returns
+    (navigator.gpu ? navigator.gpu.requestAdapter() : Promise.reject(Error("WebGPU not supported.")))
+        .then((adapter) => {
+            if (!adapter) throw Error("No WebGPU adapter.");
+            Module.adapterName = adapter.info ? (adapter.info.device || adapter.info.description || adapter.info.vendor) : "";
+            // largest buffers the adapter allows (pixel states of mandelCompute), not the defaults
+            return adapter.requestDevice({ requiredFeatures: adapter.features.has('timestamp-query') ? ['timestamp-query'] : [],
+                                           requiredLimits: { maxStorageBufferBindingSize: adapter.limits.maxStorageBufferBindingSize,
+                                                             maxBufferSize: adapter.limits.maxBufferSize } });
+        })
+        .then((device) => { Module.preinitializedWebGPUDevice = device; _onDeviceReady(1); },
+              (error)  => { console.error(error); _onDeviceReady(0); });
 } );
 
+// adapter name stored by requestAdapterAndDeviceViaJS() (GPUAdapterInfo: can be empty), malloc'ed
+EM_JS_DEPS(adapterNameDeps, "$stringToNewUTF8");
+EM_JS( char *, adapterNameViaJS, (), { return stringToNewUTF8(Module.adapterName || ""); } );
+
 void initWGPU()
 {
-    getAdapterAndDeviceViaJS();
+    startup.mark("adapter + device");
 
     instance = wgpu::CreateInstance(nullptr);
     device   = wgpu::Device(emscripten_webgpu_get_device());
     assert(device != nullptr && "Error creating the Device");
+    char *adapterName = adapterNameViaJS();
+    benchmark.setAdapter(*adapterName ? adapterName : nullptr);
+    free(adapterName);
 
     wgpu::SurfaceDescriptorFromCanvasHTMLSelector html_surface_desc;
     html_surface_desc.selector = "#canvas";
@@ -236,54 +417,6 @@ void initWGPU()
 // Initialize render pipeline
 void initRenderPipeline()
 {
-#if defined(__EMSCRIPTEN__)
-    wgpu::ShaderModuleWGSLDescriptor wgslDesc;
-    wgslDesc.code = shader;
-#else
-    wgpu::ShaderSourceWGSL wgslDesc;
-    wgslDesc.code = { shader, WGPU_STRLEN };
-#endif
-    wgpu::ShaderModuleDescriptor shaderDescriptor;
-    shaderDescriptor.nextInChain = &wgslDesc;
-    wgpu::ShaderModule module = device.CreateShaderModule(&shaderDescriptor);
-
-    wgpu::RenderPipelineDescriptor descPipeline;
-    descPipeline.layout = nullptr;
-    descPipeline.vertex.module = module;
-    descPipeline.vertex.bufferCount = 0;
-
-    // Set primitive state
-    descPipeline.primitive.topology         = wgpu::PrimitiveTopology::TriangleStrip;
-    descPipeline.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
-    descPipeline.primitive.frontFace        = wgpu::FrontFace::CCW;
-    descPipeline.primitive.cullMode         = wgpu::CullMode::None;
-
-    // BlendComponent
-    wgpu::BlendComponent blendComponent {
-        .operation = wgpu::BlendOperation::Add,
-        .srcFactor = wgpu::BlendFactor::One,
-        .dstFactor = wgpu::BlendFactor::Zero,
-    };
-    // Blend
-    wgpu::BlendState blend {
-        .color = blendComponent,
-        .alpha = blendComponent,
-    };
-    // color target attribs
-    wgpu::ColorTargetState colorTarget {
-        .nextInChain = nullptr,
-        .format      = wgpu::TextureFormat(preferredFormat),
-        .blend       = &blend,
-        .writeMask   = wgpu::ColorWriteMask::All,
-    };
-
-    // Fragment Shader
-    wgpu::FragmentState fragment;
-    fragment.module = module;
-    fragment.targetCount = 1;
-    fragment.targets = &colorTarget;
-    descPipeline.fragment = &fragment;
-
     // Uniform Buffer
     wgpu::BufferDescriptor bufferDesc {
         .nextInChain      = nullptr,
@@ -294,40 +427,33 @@ void initRenderPipeline()
     };
     ubo = device.CreateBuffer(&bufferDesc);
 
-    // @group(0) @binding(0) var<uniform> shaderData
-    wgpu::BindGroupLayoutEntry bindGroupLayoutEntry;
-    bindGroupLayoutEntry.binding               = 0;
-    bindGroupLayoutEntry.visibility            = wgpu::ShaderStage::Fragment;
-    bindGroupLayoutEntry.buffer.type           = wgpu::BufferBindingType::Uniform;
-    bindGroupLayoutEntry.buffer.minBindingSize = sizeof(shaderData_);
-
-    // BindGroupLayout
-    wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
-    bindGroupLayoutDesc.entryCount = 1;
-    bindGroupLayoutDesc.entries = &bindGroupLayoutEntry;
-    bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
-
-    // pipelineLayout
-    wgpu::PipelineLayoutDescriptor layoutDesc;
-    layoutDesc.bindGroupLayoutCount = 1;
-    layoutDesc.bindGroupLayouts = &bindGroupLayout;
-    wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&layoutDesc);
-    descPipeline.layout = pipelineLayout;
-
-    // Create Render Pipeline
-    pipeline = device.CreateRenderPipeline(&descPipeline);
+    // iteration (compute) + colorize (render) pipelines, iteration texture of surface size
+    colors.init(device);
+    mandel.init(device, preferredFormat, ubo, sizeof(shaderData_), colors);
+    mandel.resize(surfaceConfig.width, surfaceConfig.height);
+    tiles.init(device, ubo, sizeof(shaderData_));
+
+    // Deep zoom pipeline
+    perturb.init(device);
+
+    gpuTime.init(device, gpuPassCount);
 }
 
 static void updateUniformBuffer() {
     device.GetQueue().WriteBuffer( ubo, 0, &shaderData, sizeof( shaderData_ ) );
+    mandel.resetAccumulation();     // view (zoom, resize) or palette changed
+    requestRedraw();
 }
 
 void resizeSurface(const uint32_t width, const uint32_t height)
 {
     surfaceConfig.width  = width;
     surfaceConfig.height = height;
+    // iteration texture reallocated only here and in resizeIterationGrid() (render scale change)
+    mandel.resize(adaptiveScale.scaled(width), adaptiveScale.scaled(height));
 
     surface.Configure(&surfaceConfig);
+    requestRedraw();
 }
 
 WGPUTexture checkTextureStatus()
@@ -356,6 +482,7 @@ WGPUTexture checkTextureStatus()
                 surfaceConfig.height = height;
 
                 surface.Configure(&surfaceConfig);
+                requestRedraw();
             }
             return nullptr;
         }
@@ -367,6 +494,53 @@ WGPUTexture checkTextureStatus()
 }
 
 
+// f32 -> df64 -> perturbation: only pay the cost when the zoom needs it
+int currentRenderMode()
+{
+    if(renderMode != renderAuto) return renderMode;
+    if(!perturb.belowResolution(24)) return renderF32;
+    if(!perturb.belowResolution(48)) return renderDF64;
+    return renderPerturbation;
+}
+
+// builtin gradients, stops (color + position) and a preview of the LUT: true if the LUT was uploaded
+bool paletteEditor()
+{
+    if(ImGui::BeginCombo("Palette", palette::builtinName(colors.builtin()))) {
+        for(int i = 0; i < palette::builtinCount; i++)
+            if(ImGui::Selectable(palette::builtinName(i), i == colors.builtin())) colors.setBuiltin(i);
+        ImGui::EndCombo();
+    }
+
+    if(ImGui::TreeNode("Gradient")) {
+        auto &stops = colors.stops();
+        for(size_t i = 0; i < stops.size(); i++) {
+            ImGui::PushID(int(i));
+            if(ImGui::ColorEdit3("##rgb", stops[i].rgb, ImGuiColorEditFlags_NoInputs)) colors.changed();
+            ImGui::SameLine(); ImGui::SetNextItemWidth(110);
+            if(ImGui::SliderFloat("##pos", &stops[i].pos, 0.f, 1.f, "%.3f")) colors.changed();
+            bool resized = false;
+            ImGui::SameLine(); if(ImGui::SmallButton("+")) resized = colors.insertStop(i);
+            ImGui::SameLine(); if(ImGui::SmallButton("-")) resized = colors.removeStop(i);
+            ImGui::PopID();
+            if(resized) break;      // stops changed size: next frame
+        }
+        ImGui::TreePop();
+    }
+    const bool uploaded = colors.upload();
+
+    // preview: one cycle, 128 texels of the LUT
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    const float width = ImGui::CalcItemWidth(), height = 10;
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    for(int i = 0; i < 128; i++) {
+        const uint8_t *c = colors.texels() + (i * palette::lutSize / 128) * 4;
+        drawList->AddRectFilled(ImVec2(pos.x + width * i / 128, pos.y), ImVec2(pos.x + width * (i + 1) / 128, pos.y + height), IM_COL32(c[0], c[1], c[2], 255));
+    }
+    ImGui::Dummy(ImVec2(width, height));
+    return uploaded;
+}
+
 void renderImGui()
 {
     // Start the Dear ImGui frame
@@ -375,17 +549,108 @@ void renderImGui()
     ImGui::NewFrame();
 
     // ImGui Windows
-    ImGui::SetNextWindowSize(ImVec2(270, 130), ImGuiCond_Once);
+    ImGui::SetNextWindowSize(ImVec2(300, 450), ImGuiCond_Once);
     ImGui::SetNextWindowPos(ImVec2(0,0), ImGuiCond_FirstUseEver);
     bool isVisible = true;
     bool isModified = false;
     if(ImGui::Begin("wgpuMandel", &isVisible)) {
         ImGui::BeginGroup(); {
-            isModified |= ImGui::SliderInt("Iterations",&shaderData.iterations,8,2'000);
-            isModified |= ImGui::SliderInt("HSL shades",&shaderData.nColors,2,3'000);
-            isModified |= ImGui::SliderFloat("HSL shift",&shaderData.shift,0.0,1.0);
+            // iterations: only pixels still bounded continue (f32 / df64)
+            const bool iterModified = ImGui::SliderInt("Iterations",&shaderData.iterations,8,2'000);
+            isModified |= iterModified;
+            iterationDirty |= iterModified;
+            // palette only: colorize pass, no iterations (shades: iterations of a gradient cycle)
+            isModified |= ImGui::SliderInt("Shades",&shaderData.nColors,2,3'000);
+            isModified |= ImGui::SliderFloat("Shift",&shaderData.shift,0.0,1.0);
+            isModified |= paletteEditor();
             ImGui::Text("average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 
+            iterationDirty |= ImGui::Combo("Precision", &renderMode, "Auto\0f32\0df64\0Perturbation\0");
+            if(!mandel.isResumable()) ImGui::TextDisabled("pixel states over device limits: no resume");
+            // interior checks (f32 / df64): A/B, proven inside pixels stop at once
+            bool interiorModified = ImGui::CheckboxFlags("cardioid/bulb", &shaderData.interior, 1);
+            ImGui::SameLine();
+            interiorModified |= ImGui::CheckboxFlags("periodicity", &shaderData.interior, 2);
+            if(interiorModified) { isModified = iterationDirty = true; mandel.invalidate(); }
+            // edge-adaptive AA (f32 / df64): extra samples only where the count differs from a neighbour
+            int aaMode = mandel.antialias() == 16 ? 2 : mandel.antialias() == 4 ? 1 : 0;
+            if(ImGui::Combo("AA", &aaMode, "off\0adaptive 4x\0adaptive 16x\0")) {
+                mandel.setAntialias(aaMode == 2 ? 16 : aaMode == 1 ? 4 : 0);
+                isModified = iterationDirty = true;
+            }
+            if(mandel.antialias() && currentRenderMode() != renderPerturbation) {
+                const double pixels = double(mandel.width()) * mandel.height();
+                ImGui::Text("refined %.1f%% of pixels%s", 100. * std::min(mandel.refinedPixels(), mandel.refineCapacity()) / pixels,
+                            mandel.refinedPixels() > mandel.refineCapacity() ? " (capacity)" : "");
+            } else if(mandel.antialias()) ImGui::TextDisabled("AA: f32 / df64 only");
+            // temporal accumulation (f32 / df64): while the view is still, one jittered sample per frame
+            bool accumulateOn = mandel.accumulationLimit() != 0;
+            if(ImGui::Checkbox("accumulate", &accumulateOn)) mandel.setAccumulation(accumulateOn ? 256 : 0);
+            if(accumulateOn) { ImGui::SameLine(); ImGui::Text("%u / %u samples", std::max(1u, mandel.accumulatedSamples()), mandel.accumulationLimit()); }
+            // tile cache (f32): budget change reallocates the atlas, only when the slider is released
+            if(ImGui::Checkbox("tile cache", &useTileCache)) {
+                if(!useTileCache) tiles.release();      // atlas VRAM freed, allocated again at next use
+                iterationDirty = true; mandel.invalidate();
+            }
+            if(useTileCache) {
+                static int budgetMB = int(tiles.budget());
+                ImGui::SliderInt("VRAM MB", &budgetMB, 16, 256);
+                if(ImGui::IsItemDeactivatedAfterEdit()) { tiles.setBudget(uint32_t(budgetMB)); iterationDirty = true; }
+                const tileCache::stats &ts = tiles.counters();
+                if(currentRenderMode() == renderF32) ImGui::Text("level %d, %u / %u tiles", ts.level, ts.resident, ts.capacity);
+                else ImGui::TextDisabled("tile cache: f32 only");
+                ImGui::Text("hit %llu miss %llu evict %llu", (unsigned long long) ts.hits, (unsigned long long) ts.misses, (unsigned long long) ts.evictions);
+                if(diskTiles.isOpen()) {
+                    const tileStore::stats ds = diskTiles.counters();
+                    ImGui::Text("disk %llu tiles, loaded %llu, queued %u", (unsigned long long) ds.records, (unsigned long long) ts.loads, ds.queued);
+                }
+            }
+            const expDouble &scale = perturb.scaleY();
+            ImGui::Text("zoom 1e%.1f", -double(scale.e) * 0.30103 - std::log10(std::fabs(scale.m)) + std::log10(1.5));
+            ImGui::SameLine(); ImGui::Text(" - %s", currentRenderMode() == renderF32 ? "f32" : currentRenderMode() == renderDF64 ? "df64" : "perturbation");
+            if(currentRenderMode() == renderPerturbation) {
+                ImGui::Text("%d bits, reference %d / %d", perturb.precisionBits(), perturb.referenceLength(0), perturb.referenceLength(1));
+                ImGui::Text("glitched pixels: %u", perturb.glitchedPixels());
+                ImGui::Checkbox("BLA", &perturb.useBLA);       // perturb.needsUpdate() follows BLA changes
+                if(perturb.useBLA) { ImGui::SameLine(); ImGui::SliderInt("tol 2^", &perturb.blaToleranceLog2, -40, -8); }
+            }
+
+            // GPU ms of the passes, last gpuTimer::historySize timed frames (iterate: only frames that run it)
+            if(gpuTime.isEnabled()) {
+                static const char *passNames[gpuPassCount] = { "iterate", "colorize", "ImGui" };
+                ImGui::Text("GPU ms     min    avg    p99");
+                for(int i = 0; i < gpuPassCount; i++) {
+                    const gpuTimer::stats st = gpuTime.passStats(i);
+                    ImGui::Text("%-8s %6.3f %6.3f %6.3f", passNames[i], st.min, st.avg, st.p99);
+                }
+            } else ImGui::TextDisabled("GPU timestamps not supported");
+
+            // adaptive render scale (needs the GPU ms of the iterations): grid follows the budget while the view changes
+            if(gpuTime.isEnabled()) {
+                ImGui::Checkbox("adaptive scale", &adaptiveScale.enabled);
+                if(adaptiveScale.enabled) {
+                    ImGui::SameLine(); ImGui::Text("%.0f%% - %ux%u", adaptiveScale.scale() * 100.f, mandel.width(), mandel.height());
+                    ImGui::SliderFloat("budget ms", &adaptiveScale.budgetMs, 1.f, 50.f, "%.1f");
+                    ImGui::SliderFloat("min scale", &adaptiveScale.minScale, .125f, 1.f, "%.3f");
+                    ImGui::SliderFloat("max scale", &adaptiveScale.maxScale, .125f, 1.f, "%.3f");
+                }
+            }
+
+            // CPU frame time (drawn frames, from checkTextureStatus() to Tick()): percentiles 5% .. 100% + p99
+            {
+                float pct[21], ms[21];
+                for(int i = 0; i < 20; i++) pct[i] = float(i + 1) * .05f;
+                pct[20] = .99f;
+                if(profiler.frameTimePercentiles(pct, ms, 21)) {
+                    ImGui::PlotHistogram("##frameTime", ms, 20, 0, "CPU ms: percentiles", 0.f, ms[19], ImVec2(0, 40));
+                    ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f ms", ms[9], ms[18], ms[20]);
+                }
+#if !defined(__EMSCRIPTEN__)
+                ImGui::TextDisabled("F12: last %.0f s trace -> %s", traceSeconds, traceFile);
+                if(ImGui::IsKeyPressed(ImGuiKey_F12, false)) profiler.writeChromeTrace(traceFile, traceSeconds);
+#endif
+            }
+
         } ImGui::EndGroup();
     } ImGui::End();
 
@@ -395,10 +660,23 @@ void renderImGui()
     if(isModified) updateUniformBuffer(); // if data are changed, is necessary to update UBO
 }
 
+// async work not finished (readbacks, deep zoom refinement, accumulation, scaled grid): the loop keeps
+// polling and drawing, every frame ticks the device and moves it on (no sleep until the next input)
+bool workInFlight()
+{
+    return (currentRenderMode() == renderPerturbation && perturb.isBusy()) ||
+           mandel.refinePending() || tiles.storePending() ||
+           (currentRenderMode() != renderPerturbation && mandel.accumulationPending()) ||
+           adaptiveScale.isScaled();        // back to native resolution when the view is still
+}
+
 void mainLoop()
 {
-    // check for click: Mandelbrot zoomIn / zoomOut
-    checkMouseButtonAction();
+    // minimized: suspended (0 x 0 window, nothing to present)
+    if((SDL_GetWindowFlags(fwWindow) & SDL_WINDOW_MINIMIZED) != 0) return;
+
+    // check for click: Mandelbrot zoomIn / zoomOut (not while the benchmark drives the view)
+    if(!benchmark.isRunning()) checkMouseButtonAction();
 
     // React to changes in screen size
     int width, height;
@@ -406,13 +684,24 @@ void mainLoop()
     if (width != surfaceConfig.width || height != surfaceConfig.height)
     {
         resizeSurface(width, height);
-        appResizeArea(width, height); // re-adjust Mandelbrot aspect-ratio
+        appResizeArea(mandel.width(), mandel.height()); // re-adjust Mandelbrot aspect-ratio (iteration grid size)
     }
 
-    wgpu::Texture texture = checkTextureStatus();
+    if(benchmark.isRunning()) benchmarkView();
+
+    // draw only if something changed: events (ImGui inputs), UBO, surface, or deep zoom still refining
+    if(workInFlight()) requestRedraw(1);
+    if(!pendingFrames) return;     // no encode, no submit, no present
+
+    cpuProfiler::zone frameZone(profiler, "frame", true);
+    wgpu::Texture texture;
+    { CPU_ZONE(profiler, "checkTextureStatus"); texture = checkTextureStatus(); }
     if(!texture) return;
 
-    renderImGui();
+    { CPU_ZONE(profiler, "renderImGui"); renderImGui(); }
+    updateRenderScale();        // after ImGui: iterations / budget edited in this frame
+
+    cpuProfiler::zone encodeZone(profiler, "encode");
 
     // TextureViewDescriptor
     wgpu::TextureViewDescriptor descTextureView = {
@@ -452,49 +741,77 @@ void mainLoop()
     // CommandEncoder
     wgpu::CommandEncoderDescriptor descEncoder;
     wgpu::CommandEncoder encoder = device.CreateCommandEncoder(&descEncoder);
+    gpuTime.beginFrame();
+
+    // iterations: only when something but the palette changed
+    const int  currentMode = currentRenderMode();
+    const bool deepZoom = currentMode == renderPerturbation;
+    if(deepZoom) {
+        if(iterationDirty || perturb.needsUpdate()) {
+            mandel.discardRefinement(encoder);      // AA samples of a previous f32 / df64 compute
+            perturb.compute(encoder, shaderData.iterations, mandel.iterationView(), gpuTime.computeWrites(gpuIterate));
+        }
+    }
+    else if(iterationDirty) {
+        // tile cache: only missing tiles iterate (false: view not cacheable, regular compute)
+        bool cached = false;
+        if(useTileCache && currentMode == renderF32) {
+            mandel.discardRefinement(encoder);
+            cached = tiles.render(encoder, perturb.centerX(), perturb.centerY(), perturb.scaleX().toDouble(), perturb.scaleY().toDouble(),
+                                  mandel.width(), mandel.height(), shaderData.iterations, shaderData.interior, mandel.iterationView(), gpuTime.computeWrites(gpuIterate));
+        }
+        if(cached) mandel.invalidate();     // pixel states of mandel are stale: next compute() from z = 0
+        else mandel.compute(encoder, currentMode == renderDF64 ? mandelCompute::df64 : mandelCompute::f32, gpuTime.computeWrites(gpuIterate));
+    }
+    else mandel.accumulate(encoder, gpuTime.computeWrites(gpuIterate));     // view still: one more jittered sample (if enabled)
+    iterationDirty = false;
+    tiles.storeTiles(encoder);      // computed tiles queued for the disk store (--tile-store), a few per frame
 
-    // RenderPassEncoder
+    // RenderPassEncoder: colorize, then ImGui in its own pass (timed separately)
+    descRenderPass.timestampWrites = gpuTime.renderWrites(gpuColorize);
     wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&descRenderPass);
-    pass.SetPipeline(pipeline);
-
-    // Bind the uniform buffer.
-    wgpu::BindGroupEntry entryBindingGroup {
-        .nextInChain    = nullptr,
-        .binding        = 0,
-        .buffer         = ubo,
-        .offset         = 0,
-        .size           = sizeof( shaderData_ ),
-    };
-    // BindGroup descriptor
-    wgpu::BindGroupDescriptor descBindGroup {
-        .nextInChain    = nullptr,
-        .label          = nullptr,
-        .layout         = bindGroupLayout,
-        .entryCount     = 1,
-        .entries        = &entryBindingGroup,
-    };
-    // BindGroup
-    wgpu::BindGroup bindGroup  = device.CreateBindGroup(&descBindGroup);
-    pass.SetBindGroup(0, bindGroup, 0, nullptr );
-
-    pass.Draw(4, 1, 0, 0);
+    mandel.colorize(pass);
+    pass.End();
 
+    colorAttachments.loadOp        = wgpu::LoadOp::Load;
+    descRenderPass.timestampWrites = gpuTime.renderWrites(gpuImGui);
+    pass = encoder.BeginRenderPass(&descRenderPass);
     ImGui_ImplWGPU_RenderDrawData(ImGui::GetDrawData(), pass.Get()); // add Imgui RenderPass data
     pass.End();
 
+    gpuTime.resolve(encoder);
     wgpu::CommandBufferDescriptor cmd_buffer_desc;
     wgpu::CommandBuffer cmd_buffer = encoder.Finish(&cmd_buffer_desc);
-    device.GetQueue().Submit(1, &cmd_buffer);
+    encodeZone.end();
+
+    { CPU_ZONE(profiler, "Submit"); device.GetQueue().Submit(1, &cmd_buffer); }
+    gpuTime.afterSubmit();
+
+    if(deepZoom) { CPU_ZONE(profiler, "perturb.afterSubmit"); perturb.afterSubmit(); }    // glitch counters: secondary reference on glitched pixels
+    mandel.afterSubmit();       // AA refined pixels counter
+    tiles.afterSubmit();        // computed tiles -> disk store (writer thread)
 
 #if !defined(__EMSCRIPTEN__)
-    surface.Present();
+    { CPU_ZONE(profiler, "Present"); surface.Present(); }
     // Tick needs to be called in Dawn to display validation errors
-    device.Tick();
+    { CPU_ZONE(profiler, "Tick"); device.Tick(); }
 #endif
+    pendingFrames--;
+    benchmarkFrameDone();
+
+    // cold / warm start: blob cache hits are the pipelines not compiled
+    if(startup.finish("first present") && printStartup) {
+        startup.print();
+        const blobCache::stats bc = pipelineCache.counters();
+        if(pipelineCache.isOpen()) printf("blob cache: %llu hits, %llu misses, %llu stored, %llu rejected\n", (unsigned long long) bc.hits,
+                                          (unsigned long long) bc.misses, (unsigned long long) bc.stores, (unsigned long long) bc.rejected);
+    }
 }
 
-void initImGui()
+// CPU side of ImGui: context, style, platform backend, font atlas (no device)
+void initImGuiContext()
 {
+    CPU_ZONE(profiler, "startup: imgui context");
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -506,16 +823,11 @@ void initImGui()
     ImGui::StyleColorsDark();
     //ImGui::StyleColorsLight();
 
-    // Setup Platform/Renderer backends
+    // Setup Platform backend
     ImGui_ImplSDL2_InitForOther(fwWindow);
-    
-    ImGui_ImplWGPU_InitInfo init_info;
-    init_info.Device = device.Get();
-    init_info.NumFramesInFlight = 3;
-    init_info.RenderTargetFormat = (WGPUTextureFormat) preferredFormat;
-    init_info.DepthStencilFormat = WGPUTextureFormat_Undefined;
-    ImGui_ImplWGPU_Init(&init_info);
 
+    // font atlas on the CPU now (no device needed), uploaded by the renderer backend
+    io.Fonts->Build();
 #ifdef __EMSCRIPTEN__
     // For an Emscripten build we are disabling file-system access, so let's not attempt to do a fopen() of the imgui.ini file.
     // You may manually call LoadIniSettingsFromMemory() to load settings from your own storage.
@@ -523,52 +835,158 @@ void initImGui()
 #endif
 }
 
-// Main code
-int main(int, char**)
+// renderer backend: needs device and surface format
+void initImGuiRenderer()
+{
+    CPU_ZONE(profiler, "startup: imgui renderer");
+    ImGui_ImplWGPU_InitInfo init_info;
+    init_info.Device = device.Get();
+    init_info.NumFramesInFlight = 3;
+    init_info.RenderTargetFormat = (WGPUTextureFormat) preferredFormat;
+    init_info.DepthStencilFormat = WGPUTextureFormat_Undefined;
+    ImGui_ImplWGPU_Init(&init_info);
+}
+
+// device ready: surface, ImGui renderer and pipelines
+void initGraphics()
 {
 #if !defined(__EMSCRIPTEN__)
-    #if defined(__linux__)
-    #warning "LINUX USER: Please read here..."
-    // it's necessary to specify  X11 or Wayland: use "wayland" instead of "x11" or ... default x11: it works also in wayland
-    SDL_SetHint(SDL_HINT_VIDEODRIVER, "x11");  // or (outside code) export SDL_VIDEODRIVER=wayland environment variable
-    #endif                                     // or    "      "    export SDL_VIDEODRIVER=$XDG_SESSION_TYPE to get the current session type
+    initSurface();
+#else
+    initWGPU();
 #endif
-    // Init SDL
-    SDL_Init(SDL_INIT_VIDEO);
-    fwWindow = SDL_CreateWindow(appTitle, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, initialWindowWidth, initialWindowHeight, SDL_WINDOW_RESIZABLE);
 
-    initWGPU();
+    initImGuiRenderer();
+    startup.mark("imgui");
 
-    initRenderPipeline();
+    // shader modules and pipelines need the device: from the blob cache on warm starts (--blob-cache)
+    { CPU_ZONE(profiler, "startup: pipelines"); initRenderPipeline(); }
+    startup.mark("pipeline");
     initMandel();
-
-    initImGui();
+    benchmark.addInfo("interior", shaderData.interior);
+    benchmark.addInfo("aa", int(mandel.antialias()));
+    benchmark.addInfo("tileCache", useTileCache ? int(tiles.budget()) : 0);
+    benchmark.addInfo("renderScaleBudgetMs", adaptiveScale.enabled ? int(adaptiveScale.budgetMs) : 0);
+    if(benchmark.isRequested()) benchmark.start("mandel_imgui_sdl2");
+}
 
 #ifdef __EMSCRIPTEN__
+// Startup state machine (web): main() -> requestAdapterAndDeviceViaJS() -> onDeviceReady() -> main loop
+extern "C" EMSCRIPTEN_KEEPALIVE void onDeviceReady(int ok)
+{
+    emscripten_runtime_keepalive_pop();
+    if(!ok) { printf("WebGPU device not available\n"); return; }
+    initGraphics();
+
     // Main loop
     emscripten_set_main_loop([] {
         static SDL_Event event;
-        while (SDL_PollEvent(&event)) ImGui_ImplSDL2_ProcessEvent(&event);
+        {
+            CPU_ZONE(profiler, "pollEvents");
+            while (SDL_PollEvent(&event)) { ImGui_ImplSDL2_ProcessEvent(&event); requestRedraw(); }
+        }
         mainLoop();
     }, 0, false);
+}
+#endif
+
+// Main code
+int main(int argc, char** argv)
+{
+#if !defined(__EMSCRIPTEN__)
+    // --trace [seconds]: write last seconds of CPU zones as Chrome trace at exit
+    bool traceAtExit = false;
+    for(int i = 1; i < argc; i++)
+        if(!strcmp(argv[i], "--trace")) {
+            traceAtExit = true;
+            if(i + 1 < argc && atof(argv[i + 1]) > 0) traceSeconds = atof(argv[++i]);
+        }
+        else if(!strncmp(argv[i], "--interior=", 11)) shaderData.interior = atoi(argv[i] + 11);
+        else if(!strncmp(argv[i], "--aa=", 5))        mandel.setAntialias(atoi(argv[i] + 5));
+        else if(!strncmp(argv[i], "--accumulate=", 13)) mandel.setAccumulation(std::max(0, atoi(argv[i] + 13)));
+        else if(!strcmp(argv[i], "--tile-cache"))     useTileCache = true;
+        else if(!strncmp(argv[i], "--tile-cache=", 13)) { useTileCache = true; tiles.setBudget(uint32_t(std::max(16, atoi(argv[i] + 13)))); }
+        else if(!strncmp(argv[i], "--blob-cache=", 13)) blobCacheDir = argv[i] + 13;
+        else if(!strcmp(argv[i], "--startup-report"))   printStartup = true;
+        else if(!strncmp(argv[i], "--render-scale=", 15)) { adaptiveScale.enabled = true; adaptiveScale.budgetMs = std::max(1.f, float(atof(argv[i] + 15))); }
+        else if(!strncmp(argv[i], "--tile-store=", 13)) { if(diskTiles.open(argv[i] + 13, tileCache::tileSize)) { useTileCache = true; tiles.setStore(&diskTiles); } }
+        else if(!benchmark.parseArg(argv[i])) {
+            printf("usage: %s [options]\n  --trace [seconds]       write last seconds of CPU zones (%s) at exit\n"
+                   "  --interior=N            interior checks: 0 none, 1 cardioid/bulb, 2 periodicity, 3 both (default)\n"
+                   "  --aa=N                  edge-adaptive antialiasing: 0 off (default), 4 or 16 samples on edge pixels\n"
+                   "  --accumulate=N          while the view is still, accumulate up to N jittered samples per pixel (0: off, default)\n"
+                   "  --tile-cache[=MB]       f32 tile cache pyramid, VRAM budget in MB (default 256)\n"
+                   "  --tile-store=FILE       keep the tiles of the cache in FILE (memory mapped, created if missing), enables the tile cache\n"
+                   "  --blob-cache=DIR        compiled shaders / pipelines cache (default mandel_blob_cache, empty: disabled)\n"
+                   "  --startup-report        print the time of the startup stages up to first present\n"
+                   "  --render-scale=MS       adaptive render scale: iteration grid scaled to keep the GPU ms of the iterations in MS while zooming\n%s", argv[0], traceFile, zoomBenchmark::usage());
+            return -1;
+        }
 #else
+    for(int i = 1; i < argc; i++)
+        if(!strcmp(argv[i], "--startup-report")) printStartup = true;
+        else if(!strncmp(argv[i], "--render-scale=", 15)) { adaptiveScale.enabled = true; adaptiveScale.budgetMs = std::max(1.f, float(atof(argv[i] + 15))); }
+        else benchmark.parseArg(argv[i]);
+#endif
+#if !defined(__EMSCRIPTEN__)
+    #if defined(__linux__)
+    #warning "LINUX USER: Please read here..."
+    // it's necessary to specify  X11 or Wayland: use "wayland" instead of "x11" or ... default x11: it works also in wayland
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "x11");  // or (outside code) export SDL_VIDEODRIVER=wayland environment variable
+    #endif                                     // or    "      "    export SDL_VIDEODRIVER=$XDG_SESSION_TYPE to get the current session type
+#endif
+#if !defined(__EMSCRIPTEN__)
+    // startup critical path: adapter + device (driver loading, the slowest stage) requested on its own
+    // thread, overlapped with window creation and the CPU side of ImGui (context, font atlas)
+    std::thread gpuThread(requestDevice);
+#endif
+    {
+        CPU_ZONE(profiler, "startup: window");
+        // Init SDL
+        SDL_Init(SDL_INIT_VIDEO);
+        fwWindow = SDL_CreateWindow(appTitle, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, initialWindowWidth, initialWindowHeight, SDL_WINDOW_RESIZABLE);
+    }
+    startup.mark("window");
+#ifdef __EMSCRIPTEN__
+    // the same on the web: the browser works on the request while ImGui is set up, promises resolved after main() returns
+    requestAdapterAndDeviceViaJS();
+#endif
+
+    initImGuiContext();
+    startup.mark("imgui context");
+
+#if !defined(__EMSCRIPTEN__)
+    { CPU_ZONE(profiler, "startup: wait device"); gpuThread.join(); }
+    if(device == nullptr) return -3;
+    initGraphics();
+
     SDL_Event event;
     bool canCloseWindow = false;
     // Main loop
     while (!canCloseWindow) {
-        while (SDL_PollEvent(&event)) // Poll and handle events (inputs, window resize, etc.)
+        // idle or minimized: sleep on first event, then poll and handle the others (inputs, window resize, etc.)
+        const bool idle = (!pendingFrames && !workInFlight()) || (SDL_GetWindowFlags(fwWindow) & SDL_WINDOW_MINIMIZED) != 0;
+        cpuProfiler::zone eventsZone(profiler, idle ? "waitEvents" : "pollEvents");
+        for(bool hasEvent = idle ? SDL_WaitEvent(&event) : SDL_PollEvent(&event); hasEvent; hasEvent = SDL_PollEvent(&event))
         {
             ImGui_ImplSDL2_ProcessEvent(&event);
+            requestRedraw();
             if (event.type == SDL_QUIT ||
                (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE &&
                 event.window.windowID == SDL_GetWindowID(fwWindow)))
                 canCloseWindow = true;
         }
+        eventsZone.end();
         mainLoop();
     }
-#endif
+    if(traceAtExit) profiler.writeChromeTrace(traceFile, traceSeconds);
     // All class destructors release the own object
     SDL_DestroyWindow(fwWindow);
     SDL_Quit();
     return 0;
+#else
+    // keep the runtime alive after main() returns: the device is requested, onDeviceReady() goes on
+    emscripten_runtime_keepalive_push();
+    return 0;
+#endif
 }
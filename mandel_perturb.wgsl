@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Perturbation deep zoom: the reference orbit Z(n) is computed on the CPU at
+//  arbitrary precision, here only the pixel delta dz(n) = z(n) - Z(n) is iterated:
+//      dz(n+1) = 2 Z(n) dz(n) + dz(n)^2 + dc
+//  While dz is below f32 range it's kept as mantissa/exponent (float-exp)
+//  Bilinear approximation (BLA): blocks of 2^k iterations of the primary
+//  reference are replaced by dz = A dz + B dc while |dz| < R of the block
+//------------------------------------------------------------------------------
+R"(
+    struct perturbData {
+        scaleM     : vec2f,     // mScale = scaleM * 2^scaleE (half size of the view)
+        wSize      : vec2f,
+        refPos0    : vec2f,     // pixel position of primary reference (view center)
+        refPos1    : vec2f,     // pixel position of secondary reference
+        scaleE     : i32,
+        iterations : i32,
+        refLen0    : i32,       // orbit length of primary reference
+        refLen1    : i32,       // orbit length of secondary reference (0: not available)
+        refOffset1 : i32,       // first element of secondary orbit in orbit buffer
+        glitchTol  : f32,       // Pauldelbrot criterion: |Z + dz|^2 < glitchTol * |Z|^2
+        blaLevels  : i32,       // 0: BLA disabled
+        blaCount0  : i32,       // entries of level 0, level k has blaCount0 >> k
+        blaOffset  : array<vec4i, 8>,   // first entry of level k: blaOffset[k / 4][k % 4]
+    };
+    struct blaData {
+        a    : vec2f,           // A = a * 2^ae, B = b * 2^be
+        b    : vec2f,
+        ae   : i32,
+        be   : i32,
+        logR : f32,             // valid while log2|dz| < logR
+    };
+    struct glitchData {
+        count  : atomic<u32>,
+        sample : atomic<u32>,   // (y << 16) | x of a pixel glitched with the primary reference
+    };
+    @group(0) @binding(0) var<uniform> pd : perturbData;
+    @group(0) @binding(1) var<storage, read> orbit : array<vec2f>;
+    @group(0) @binding(2) var<storage, read_write> glitchMask : array<u32>;   // 0: primary, 1: secondary, 2: glitched on both
+    @group(0) @binding(3) var<storage, read_write> glitch : glitchData;
+    @group(0) @binding(4) var<storage, read> bla : array<blaData>;
+    @group(0) @binding(5) var iterTex : texture_storage_2d<r32float, write>;  // smooth count, as cs() of mandel.wgsl
+
+    fn cmul(a: vec2f, b: vec2f) -> vec2f { return vec2f(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x); }
+
+    const fe32Limit : i32 = -60;    // dz exponent below it: float-exp iteration
+
+    struct perturbResult {
+        i        : i32,
+        zz       : f32,         // |z|^2 at escape
+        glitched : bool,
+    };
+
+    struct fexp {
+        d : vec2f,              // value = d * 2^e
+        e : i32,
+    };
+    fn normalizeFexp(v: fexp) -> fexp
+    {
+        let m = max(abs(v.d.x), abs(v.d.y));
+        if (m == 0.) { return v; }
+        let k = frexp(m).exp;
+        return fexp(ldexp(v.d, vec2i(-k)), v.e + k);
+    }
+
+    // largest valid BLA block from dz(n): returns steps skipped (0: none) and dz(n + steps)
+    struct blaResult {
+        z     : fexp,
+        steps : i32,
+    };
+    fn blaSkip(n: i32, z: fexp, dcM: vec2f, dcE: i32) -> blaResult
+    {
+        var r = blaResult(z, 0);
+        if (n < 1 || pd.blaLevels < 2) { return r; }
+        let j0 = n - 1;
+        let m = length(z.d);
+        let logDz = select(-1e30, log2(m) + f32(z.e), m > 0.);
+        // level k starts only where j0 is multiple of 2^k; level 0 is a plain step
+        for (var k = min(i32(countTrailingZeros(u32(j0))), pd.blaLevels - 1); k >= 1; k = k - 1) {
+            let j = j0 >> u32(k);
+            if (j >= (pd.blaCount0 >> u32(k))) { continue; }
+            let b = bla[pd.blaOffset[k / 4][k % 4] + j];
+            if (logDz < b.logR) {
+                // A dz + B dc, with common exponent
+                let e1 = b.ae + z.e;
+                let e2 = b.be + dcE;
+                let e  = max(e1, e2);
+                r.z = normalizeFexp(fexp(ldexp(cmul(b.a, z.d), vec2i(e1 - e)) + ldexp(cmul(b.b, dcM), vec2i(e2 - e)), e));
+                r.steps = 1 << u32(k);
+                return r;
+            }
+        }
+        return r;
+    }
+
+    fn iterate(dcM: vec2f, dcE: i32, offset: i32, len: i32, useBla: bool) -> perturbResult
+    {
+        var r = perturbResult(0, 0., false);
+        var d = vec2f(0.);      // dz = d * 2^e
+        var e = dcE;
+        var i = 1;
+
+        // float-exp phase: dz (and dc) out of f32 range, renormalized every step
+        for (; i < pd.iterations && e < fe32Limit; i = i + 1) {
+            if (i >= len) { r.glitched = true; return r; }      // reference escaped before
+            var s = blaResult(fexp(d, e), 0);
+            if (useBla) { s = blaSkip(i - 1, s.z, dcM, dcE); }
+            if (s.steps > 0) {
+                d = s.z.d; e = s.z.e;
+                i = i - 1 + s.steps;                            // dz(i - 1) -> dz(i - 1 + steps)
+            } else {
+                d = 2. * cmul(orbit[offset + i - 1], d) + ldexp(cmul(d, d), vec2i(e)) + ldexp(dcM, vec2i(dcE - e));
+                let m = max(abs(d.x), abs(d.y));
+                if (m > 0.) { let k = frexp(m).exp; d = ldexp(d, vec2i(-k)); e = e + k; }
+            }
+
+            let z = orbit[offset + i] + ldexp(d, vec2i(e));
+            if (dot(z, z) > 16.) { r.i = i; r.zz = dot(z, z); return r; }
+        }
+
+        // f32 phase
+        var dz = ldexp(d, vec2i(e));
+        let dc = ldexp(dcM, vec2i(dcE));
+        for (; i < pd.iterations; i = i + 1) {
+            if (i >= len) { r.glitched = true; return r; }
+            var s = blaResult(fexp(dz, 0), 0);
+            if (useBla) { s = blaSkip(i - 1, normalizeFexp(s.z), dcM, dcE); }
+            if (s.steps > 0) {
+                dz = ldexp(s.z.d, vec2i(s.z.e));
+                i = i - 1 + s.steps;
+            }
+            else { dz = 2. * cmul(orbit[offset + i - 1], dz) + cmul(dz, dz) + dc; }
+
+            let Z  = orbit[offset + i];
+            let z  = Z + dz;
+            let zz = dot(z, z);
+            if (zz > 16.) { r.i = i; r.zz = zz; return r; }
+            if (zz < pd.glitchTol * dot(Z, Z)) { r.glitched = true; return r; }
+        }
+        return r;
+    }
+
+    @compute @workgroup_size(8, 8) fn cs(@builtin(global_invocation_id) id: vec3u)
+    {
+        let px  = id.xy;
+        if (any(px >= vec2u(pd.wSize))) { return; }
+        let position = vec2f(px) + .5;          // pixel center
+        let idx = px.y * u32(pd.wSize.x) + px.x;
+        let mask = glitchMask[idx];
+        let useSecondary = mask != 0u && pd.refLen1 > 0;
+
+        // dc relative to the reference: same c of fs() in mandel.wgsl, without absolute coords
+        let refPos = select(pd.refPos0, pd.refPos1, useSecondary);
+        let dcM = (position - refPos) / pd.wSize * (pd.scaleM * 2.);
+
+        var r: perturbResult;
+        if (useSecondary) { r = iterate(dcM, pd.scaleE, pd.refOffset1, pd.refLen1, false); }
+        else              { r = iterate(dcM, pd.scaleE, 0, pd.refLen0, true); }
+
+        if (r.glitched) {
+            atomicAdd(&glitch.count, 1u);
+            if (useSecondary) { glitchMask[idx] = 2u; }
+            else {
+                glitchMask[idx] = 1u;
+                atomicStore(&glitch.sample, (px.y << 16u) | px.x);
+            }
+        }
+
+        var mu = 0.;
+        if (r.i > 0) { mu = max(f32(r.i) + 1. - log2(.5 * log2(r.zz)), 1e-3); }
+        textureStore(iterTex, px, vec4f(mu, 0., 0., 1.));
+    }
+)"
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Zoom reprojection: every new pixel takes the state of the nearest pixel of
+//  the previous frame (pixelState of mandel.wgsl), when the distance between
+//  the two centers (plus the error already carried) is below half pixel.
+//  Other pixels (and borders exposed by a zoom-out) restart with n = 0.
+//------------------------------------------------------------------------------
+R"(
+    struct pixelState {
+        z   : vec4f,
+        n   : i32,
+        zz  : f32,
+        err : f32,              // reprojection error carried by the pixel (pixels)
+    };
+    struct reprojectData {
+        ratio  : vec2f,         // new pixel size / old pixel size
+        offset : vec2f,         // old frame coords: q = p * ratio + offset
+        size   : vec2u,
+    };
+    @group(0) @binding(0) var<uniform> rd : reprojectData;
+    @group(0) @binding(1) var<storage, read> src : array<pixelState>;
+    @group(0) @binding(2) var<storage, read_write> dst : array<pixelState>;
+
+    @compute @workgroup_size(8, 8) fn reproject(@builtin(global_invocation_id) id: vec3u)
+    {
+        if (any(id.xy >= rd.size)) { return; }
+        let q = (vec2f(id.xy) + .5) * rd.ratio + rd.offset;    // pixel center in the old frame
+        let k = floor(q);
+
+        var s = pixelState(vec4f(0.), 0, 0., 0.);
+        if (all(k >= vec2f(0.)) && all(k < vec2f(rd.size))) {
+            let old = src[u32(k.y) * rd.size.x + u32(k.x)];
+            // in new pixels: center distance + old error
+            let d = (abs(q - (k + .5)) + old.err) / rd.ratio;
+            let err = max(d.x, d.y);
+            if (err <= .5) { s = old; s.err = err; }
+        }
+        dst[id.y * rd.size.x + id.x] = s;
+    }
+)"
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Tile cache pyramid (tileCache.h), appended to mandel.wgsl (iterateFrom(),
+//  smoothIter(), iterTex)
+//   - csTile(): smooth counts of the missing tiles (one per workgroup z) in
+//     their atlas slot, tileSize x tileSize pixels at the step of the level
+//   - csComposite(): iteration texture of the view from the atlas, nearest
+//     tile pixel (tile pixels are 1 .. 2 times smaller than view pixels)
+//------------------------------------------------------------------------------
+R"(
+    const tileSize = 256u;
+
+    struct tileData {
+        gridOrigin : vec2f,     // view pixel coords of the corner of the first visible tile
+        ratio      : f32,       // tile pixels per view pixel, [1, 2)
+        step       : f32,       // complex units per tile pixel (level)
+        cols       : u32,       // visible tiles: cols x rows in tileTable
+        rows       : u32,
+        perRow     : u32,       // slots per row of the atlas
+    };
+    struct tileJob {
+        c0   : vec2f,           // c of the tile corner
+        slot : u32,
+        pad  : u32,
+    };
+    @group(0) @binding(12) var atlas : texture_storage_2d<r32float, write>;    // csTile() only
+    @group(0) @binding(13) var<storage, read> jobs : array<tileJob>;
+    @group(0) @binding(14) var<storage, read> tileTable : array<u32>;         // atlas slot of visible tiles
+    @group(0) @binding(15) var<uniform> td : tileData;
+    @group(0) @binding(16) var atlasIn : texture_2d<f32>;                      // csComposite() only
+
+    fn slotOrigin(slot: u32) -> vec2u { return vec2u(slot % td.perRow, slot / td.perRow) * tileSize; }
+
+    @compute @workgroup_size(8, 8) fn csTile(@builtin(global_invocation_id) id: vec3u)
+    {
+        let job = jobs[id.z];
+        let c = job.c0 + (vec2f(id.xy) + .5) * td.step;
+        // periodicity eps from the tile pixel: the same tile whatever view computes it
+        textureStore(atlas, slotOrigin(job.slot) + id.xy, vec4f(smoothIter(iterateFrom(c, vec2f(0.), 1, td.step)), 0., 0., 1.));
+    }
+
+    @compute @workgroup_size(8, 8) fn csComposite(@builtin(global_invocation_id) id: vec3u)
+    {
+        let size = textureDimensions(iterTex);
+        if (any(id.xy >= size)) { return; }
+
+        let q = max((vec2f(id.xy) + .5 - td.gridOrigin) * td.ratio, vec2f(0.));
+        let t = min(vec2u(q / f32(tileSize)), vec2u(td.cols, td.rows) - 1u);
+        let local = min(vec2u(q - vec2f(t * tileSize)), vec2u(tileSize - 1u));
+        let mu = textureLoad(atlasIn, slotOrigin(tileTable[t.y * td.cols + t.x]) + local, 0).r;
+        textureStore(iterTex, id.xy, vec4f(mu, 0., 0., 1.));
+    }
+)"
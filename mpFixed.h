@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Minimal arbitrary precision fixed-point number (sign + magnitude)
+//  Enough for Mandelbrot reference orbits: |values| < 2^31, precision grows
+//  with the zoom (32 bits for every limb), no external library (GMP / MPFR)
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// double mantissa + binary exponent: value = m * 2^e, range far beyond 1e-308
+struct expDouble {
+    double  m = 0;
+    int32_t e = 0;
+
+    expDouble() = default;
+    expDouble(double v, int32_t exp2 = 0) : m(v), e(exp2) { normalize(); }
+
+    void normalize() { int ex; m = std::frexp(m, &ex); e = m == 0 ? 0 : e + ex; }
+    double  toDouble() const { return std::ldexp(m, e); }   // 0 / inf when out of double range
+    int32_t log2() const { return e; }                       // floor(log2(|v|)) + 1
+
+    expDouble operator*(const expDouble &o) const { return expDouble(m * o.m, e + o.e); }
+    expDouble operator*(double v)           const { return expDouble(m * v,   e); }
+    bool operator<(const expDouble &o) const { // magnitude compare
+        if(m == 0 || o.m == 0) return std::fabs(m) < std::fabs(o.m);
+        return e != o.e ? e < o.e : std::fabs(m) < std::fabs(o.m);
+    }
+};
+
+class mpFixed {
+public:
+    // value = sign * sum(limb[k] * 2^(32*(k - (size-1)))): limb[size-1] is the integer part
+    explicit mpFixed(int numLimbs = 4) : limbs(size_t(std::max(numLimbs, 2)), 0u) {}
+    mpFixed(double v, int numLimbs) : mpFixed(numLimbs) { set(v, 0); }
+
+    int  size() const { return int(limbs.size()); }
+    int  precisionBits() const { return (size() - 1) * 32; }
+
+    // limbs needed to resolve 2^log2Scale with guardBits of margin
+    static int limbsFor(int32_t log2Scale, int guardBits = 64) { return 2 + std::max(0, -log2Scale + guardBits + 31) / 32; }
+
+    // change precision keeping the value (truncated if reduced)
+    void setPrecision(int numLimbs) {
+        numLimbs = std::max(numLimbs, 2);
+        const int diff = numLimbs - size();
+        if(diff > 0)      limbs.insert(limbs.begin(), size_t(diff), 0u);
+        else if(diff < 0) limbs.erase(limbs.begin(), limbs.begin() + (-diff));
+    }
+
+    // value = v * 2^exp2
+    void set(double v, int32_t exp2) {
+        std::fill(limbs.begin(), limbs.end(), 0u);
+        negative = v < 0;
+        if(v == 0 || !std::isfinite(v)) { negative = false; return; }
+        int ex;
+        const double mant = std::frexp(std::fabs(v), &ex);     // [.5, 1)
+        uint64_t bits = uint64_t(std::ldexp(mant, 53));          // 53 significant bits
+        // bit position (from LSB of limb[0]) of the bits LSB
+        int64_t pos = int64_t(ex) + exp2 - 53 + int64_t(size() - 1) * 32;
+        if(pos < 0) { if(pos <= -64) return; bits >>= -pos; pos = 0; }
+        for(int b = 0; b < 64 && bits; b += 32, bits >>= 32) {
+            const int64_t bitPos = pos + b;
+            const int64_t limb = bitPos / 32, shift = bitPos % 32;
+            if(limb < size())      limbs[size_t(limb)]     |= uint32_t((bits & 0xffffffffu) << shift);
+            if(shift && limb + 1 < size()) limbs[size_t(limb + 1)] |= uint32_t((bits & 0xffffffffu) >> (32 - shift));
+        }
+    }
+    void set(const expDouble &v) { set(v.m, v.e); }
+
+    double toDouble() const {
+        double v = 0;
+        for(int k = size() - 1, n = 0; k >= 0 && n < 4; k--, n++)
+            v += std::ldexp(double(limbs[size_t(k)]), 32 * (k - (size() - 1)));
+        return negative ? -v : v;
+    }
+
+    // value - toDouble() (what a double can not represent), as expDouble
+    expDouble residual() const {
+        mpFixed r = *this;
+        mpFixed d(size()); d.set(toDouble(), 0);
+        r -= d;
+        // leading limb gives the exponent
+        for(int k = size() - 1; k >= 0; k--)
+            if(r.limbs[size_t(k)]) {
+                double v = 0;
+                for(int j = k, n = 0; j >= 0 && n < 3; j--, n++)
+                    v += std::ldexp(double(r.limbs[size_t(j)]), 32 * (j - k));
+                return expDouble(r.negative ? -v : v, 32 * (k - (size() - 1)));
+            }
+        return expDouble();
+    }
+
+    mpFixed operator-() const { mpFixed r = *this; if(!r.isZero()) r.negative = !r.negative; return r; }
+
+    mpFixed &operator+=(const mpFixed &o) { addSigned(o, o.negative); return *this; }
+    mpFixed &operator-=(const mpFixed &o) { addSigned(o, !o.negative); return *this; }
+    mpFixed operator+(const mpFixed &o) const { mpFixed r = *this; r += o; return r; }
+    mpFixed operator-(const mpFixed &o) const { mpFixed r = *this; r -= o; return r; }
+
+    mpFixed operator*(const mpFixed &o) const {
+        const int n = size();
+        mpFixed r(n);
+        if(isZero() || o.isZero()) return r;
+        // full product (2n limbs), result = product >> 32*(n-1)
+        std::vector<uint64_t> prod(size_t(2 * n), 0);
+        for(int i = 0; i < n; i++) {
+            const uint64_t a = limbs[size_t(i)];
+            if(!a) continue;
+            uint64_t carry = 0;
+            for(int j = 0; j < o.size() && i + j < 2 * n; j++) {
+                const uint64_t t = a * o.limbs[size_t(j)] + prod[size_t(i + j)] + carry;
+                prod[size_t(i + j)] = t & 0xffffffffu;
+                carry = t >> 32;
+            }
+            for(int k = i + o.size(); carry && k < 2 * n; k++) {
+                const uint64_t t = prod[size_t(k)] + carry;
+                prod[size_t(k)] = t & 0xffffffffu;
+                carry = t >> 32;
+            }
+        }
+        for(int k = 0; k < n; k++) r.limbs[size_t(k)] = uint32_t(prod[size_t(k + n - 1)]);
+        r.negative = (negative != o.negative) && !r.isZero();
+        return r;
+    }
+
+    mpFixed &mul2() {   // *2
+        uint32_t carry = 0;
+        for(auto &l : limbs) { const uint32_t next = l >> 31; l = (l << 1) | carry; carry = next; }
+        return *this;
+    }
+
+    bool isZero() const { for(auto l : limbs) if(l) return false; return true; }
+
+private:
+    std::vector<uint32_t> limbs;    // little endian
+    bool negative = false;
+
+    // magnitude compare: -1, 0, 1
+    int cmpMag(const mpFixed &o) const {
+        for(int k = size() - 1; k >= 0; k--)
+            if(limbs[size_t(k)] != o.limbs[size_t(k)]) return limbs[size_t(k)] < o.limbs[size_t(k)] ? -1 : 1;
+        return 0;
+    }
+
+    // this += (oNeg ? -|o| : |o|), o is resized to this precision
+    void addSigned(const mpFixed &src, bool oNeg) {
+        mpFixed o = src;
+        if(o.size() != size()) o.setPrecision(size());
+        if(negative == oNeg) {                  // same sign: add magnitudes
+            uint64_t carry = 0;
+            for(int k = 0; k < size(); k++) {
+                const uint64_t t = uint64_t(limbs[size_t(k)]) + o.limbs[size_t(k)] + carry;
+                limbs[size_t(k)] = uint32_t(t); carry = t >> 32;
+            }
+        } else {                                // different sign: subtract smaller magnitude from larger
+            const bool swapSign = cmpMag(o) < 0;
+            const mpFixed &big = swapSign ? o : *this;
+            const mpFixed &small = swapSign ? *this : o;
+            std::vector<uint32_t> res(limbs.size());
+            int64_t borrow = 0;
+            for(int k = 0; k < size(); k++) {
+                int64_t t = int64_t(big.limbs[size_t(k)]) - small.limbs[size_t(k)] - borrow;
+                borrow = t < 0; if(t < 0) t += int64_t(1) << 32;
+                res[size_t(k)] = uint32_t(t);
+            }
+            limbs.swap(res);
+            if(swapSign) negative = oNeg;
+        }
+        if(isZero()) negative = false;
+    }
+};
@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+
+#include "palette.h"
+
+// hsl: hue ramp of hsl2rgb() (S = 1, L = .5) is piecewise linear between the 6 primaries/secondaries: same colors
+static const palette::stop hslStops[] = {
+    { 0.f/6.f, { 1, 0, 0 } }, { 1.f/6.f, { 1, 1, 0 } }, { 2.f/6.f, { 0, 1, 0 } },
+    { 3.f/6.f, { 0, 1, 1 } }, { 4.f/6.f, { 0, 0, 1 } }, { 5.f/6.f, { 1, 0, 1 } },
+};
+static const palette::stop fireStops[] = {
+    { 0.f, { 0, 0, 0 } }, { .25f, { .7f, .05f, 0 } }, { .5f, { 1, .5f, 0 } }, { .75f, { 1, .95f, .4f } }, { .875f, { 1, 1, 1 } },
+};
+static const palette::stop oceanStops[] = {
+    { 0.f, { 0, .02f, .15f } }, { .3f, { 0, .3f, .6f } }, { .55f, { .1f, .75f, .85f } }, { .7f, { .9f, 1, 1 } }, { .85f, { .05f, .35f, .55f } },
+};
+static const palette::stop ultraFractalStops[] = {
+    { 0.f, { 0.f/255, 7.f/255, 100.f/255 } }, { .16f, { 32.f/255, 107.f/255, 203.f/255 } }, { .42f, { 1, 1, 1 } },
+    { .6425f, { 1, 170.f/255, 0 } }, { .8575f, { 0, 2.f/255, 0 } },
+};
+static const palette::stop grayscaleStops[] = {
+    { 0.f, { 0, 0, 0 } }, { .5f, { 1, 1, 1 } },
+};
+
+const char *palette::builtinName(int idx)
+{
+    static const char *names[builtinCount] = { "HSL", "Fire", "Ocean", "Ultra Fractal", "Grayscale" };
+    return idx >= 0 && idx < builtinCount ? names[idx] : "custom";
+}
+
+void palette::init(const wgpu::Device &dev)
+{
+    device = dev;
+
+    wgpu::TextureDescriptor descTexture;
+    descTexture.label         = "paletteLUT";
+    descTexture.usage         = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::TextureBinding;
+    descTexture.dimension     = wgpu::TextureDimension::e2D;
+    descTexture.size          = { lutSize, 1, 1 };
+    descTexture.format        = wgpu::TextureFormat::RGBA8Unorm;
+    descTexture.mipLevelCount = 1;
+    descTexture.sampleCount   = 1;
+    lutTexture = device.CreateTexture(&descTexture);
+    lutView    = lutTexture.CreateView();
+
+    // repeat on u: texels at both ends of the cycle are filtered together
+    wgpu::SamplerDescriptor descSampler;
+    descSampler.label        = "paletteSampler";
+    descSampler.addressModeU = wgpu::AddressMode::Repeat;
+    descSampler.addressModeV = wgpu::AddressMode::ClampToEdge;
+    descSampler.magFilter    = wgpu::FilterMode::Linear;
+    descSampler.minFilter    = wgpu::FilterMode::Linear;
+    lutSampler = device.CreateSampler(&descSampler);
+
+    if(gradient.empty()) setBuiltin(current);
+    upload();
+}
+
+void palette::setBuiltin(int idx)
+{
+    switch(idx) {
+        default:
+        case hsl:          gradient.assign(std::begin(hslStops),          std::end(hslStops));          idx = hsl; break;
+        case fire:         gradient.assign(std::begin(fireStops),         std::end(fireStops));         break;
+        case ocean:        gradient.assign(std::begin(oceanStops),        std::end(oceanStops));        break;
+        case ultraFractal: gradient.assign(std::begin(ultraFractalStops), std::end(ultraFractalStops)); break;
+        case grayscale:    gradient.assign(std::begin(grayscaleStops),    std::end(grayscaleStops));    break;
+    }
+    current = idx;
+    dirty   = true;
+}
+
+bool palette::insertStop(size_t after)
+{
+    if(after >= gradient.size()) return false;
+    const stop &a = gradient[after], &b = gradient[(after + 1) % gradient.size()];
+    const float bPos = after + 1 < gradient.size() ? b.pos : b.pos + 1.f;
+    stop s;
+    s.pos = std::fmod((a.pos + bPos) * .5f, 1.f);
+    for(int c = 0; c < 3; c++) s.rgb[c] = (a.rgb[c] + b.rgb[c]) * .5f;
+    gradient.insert(gradient.begin() + after + 1, s);
+    changed();
+    return true;
+}
+
+bool palette::removeStop(size_t idx)
+{
+    if(gradient.size() <= 2 || idx >= gradient.size()) return false;
+    gradient.erase(gradient.begin() + idx);
+    changed();
+    return true;
+}
+
+bool palette::upload()
+{
+    if(!dirty || !lutTexture) return false;
+    dirty = false;
+
+    build(gradient, lut.data());
+
+    texelCopyTexture dst;
+    dst.texture = lutTexture;
+    texelCopyBufferLayout layout;
+    layout.bytesPerRow  = lutSize * 4;
+    layout.rowsPerImage = 1;
+    const wgpu::Extent3D extent = { lutSize, 1, 1 };
+    device.GetQueue().WriteTexture(&dst, lut.data(), lut.size(), &layout, &extent);
+    return true;
+}
+
+void palette::build(const std::vector<stop> &gradient, uint8_t *rgba)
+{
+    // stops in the editor can cross: sort a copy
+    std::vector<stop> s(gradient);
+    for(auto &st : s) st.pos = std::clamp(st.pos, 0.f, 1.f);
+    std::sort(s.begin(), s.end(), [](const stop &a, const stop &b) { return a.pos < b.pos; });
+    if(s.empty()) s.push_back({ 0.f, { 0, 0, 0 } });
+
+    size_t k = 0;       // last stop <= t
+    for(uint32_t i = 0; i < lutSize; i++) {
+        const float t = (float(i) + .5f) / float(lutSize);
+        while(k + 1 < s.size() && s[k + 1].pos <= t) k++;
+
+        // before the first stop or after the last one: segment last -> first of the next cycle
+        const stop *a, *b;
+        float aPos, bPos;
+        if(t < s.front().pos)      { a = &s.back(); b = &s.front(); aPos = a->pos - 1.f; bPos = b->pos; }
+        else if(k + 1 == s.size()) { a = &s.back(); b = &s.front(); aPos = a->pos;       bPos = b->pos + 1.f; }
+        else                       { a = &s[k];     b = &s[k + 1];  aPos = a->pos;       bPos = b->pos; }
+
+        const float w = bPos > aPos ? (t - aPos) / (bPos - aPos) : 0.f;
+        for(int c = 0; c < 3; c++)
+            rgba[i * 4 + c] = uint8_t(std::lround(std::clamp(a->rgb[c] + (b->rgb[c] - a->rgb[c]) * w, 0.f, 1.f) * 255.f));
+        rgba[i * 4 + 3] = 255;
+    }
+}
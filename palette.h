@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Palette LUT: one cycle of a cyclic gradient in a lutSize x 1 RGBA8 texture,
+//  sampled (linear filter, repeat) by the colorize pass at shift + mu / nColors
+//   - gradient: color stops in [0, 1], the segment after the last stop goes
+//     back to the first one (no seam when the palette repeats)
+//   - nColors / shift only move the texture coordinate: the LUT is built on
+//     the CPU and uploaded only when the gradient changes (upload())
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "wgpuUtils.h"
+
+class palette {
+public:
+    static constexpr uint32_t lutSize = 4096;
+
+    struct stop {
+        float pos;              // [0, 1]
+        float rgb[3];
+    };
+    enum builtins { hsl, fire, ocean, ultraFractal, grayscale, builtinCount };
+
+    void init(const wgpu::Device &device);
+
+    static const char *builtinName(int idx);        // "custom" if not a builtin
+    void setBuiltin(int idx);
+    int  builtin() const { return current; }        // -1: edited
+
+    // editable stops: call changed() after an edit
+    std::vector<stop> &stops() { return gradient; }
+    void changed() { dirty = true; current = -1; }
+    bool insertStop(size_t after);                  // midpoint between stop after and the next one
+    bool removeStop(size_t idx);                    // at least 2 stops are kept
+
+    // rebuild and upload the LUT if the gradient changed: false if nothing done
+    bool upload();
+
+    const uint8_t *texels() const { return lut.data(); }   // last uploaded LUT (RGBA, lutSize): UI preview
+
+    const wgpu::TextureView &view()    const { return lutView; }
+    const wgpu::Sampler     &sampler() const { return lutSampler; }
+
+    // lutSize RGBA texels of the gradient (texel i at (i + .5) / lutSize)
+    static void build(const std::vector<stop> &gradient, uint8_t *rgba);
+
+private:
+    wgpu::Device      device;
+    wgpu::Texture     lutTexture;
+    wgpu::TextureView lutView;
+    wgpu::Sampler     lutSampler;
+    std::vector<stop> gradient;
+    std::vector<uint8_t> lut = std::vector<uint8_t>(lutSize * 4);
+    int               current = hsl;
+    bool              dirty   = true;
+};
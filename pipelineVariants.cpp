@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cstdio>
+
+#include "pipelineVariants.h"
+
+void pipelineVariants::init(const wgpu::Device &dev, const wgpu::ShaderModule &shaderModule, const wgpu::PipelineLayout &pipelineLayout,
+                            wgpu::TextureFormat colorFormat)
+{
+    device = dev;
+    module = shaderModule;
+    layout = pipelineLayout;
+    format = colorFormat;
+}
+
+void pipelineVariants::describe(descriptor &d, const variant &v) const
+{
+    // override constants of mandel.wgsl
+    d.constants[0].key = "escapeRadius"; d.constants[0].value = v.escapeRadius;
+    d.constants[1].key = "unroll";       d.constants[1].value = v.unroll;
+    d.constants[2].key = "smoothColor";  d.constants[2].value = v.smooth ? 1. : 0.;
+    d.constants[3].key = "power";        d.constants[3].value = v.power;
+
+    d.blend.color = { wgpu::BlendOperation::Add, wgpu::BlendFactor::One, wgpu::BlendFactor::Zero };
+    d.blend.alpha = d.blend.color;
+
+    d.target.format    = format;
+    d.target.blend     = &d.blend;
+    d.target.writeMask = wgpu::ColorWriteMask::All;
+
+    d.fragment.module        = module;
+    d.fragment.constantCount = 4;
+    d.fragment.constants     = d.constants;
+    d.fragment.targetCount   = 1;
+    d.fragment.targets       = &d.target;
+
+    d.desc.layout             = layout;
+    d.desc.vertex.module      = module;
+    d.desc.vertex.bufferCount = 0;
+    d.desc.primitive.topology         = wgpu::PrimitiveTopology::TriangleStrip;
+    d.desc.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+    d.desc.primitive.frontFace        = wgpu::FrontFace::CCW;
+    d.desc.primitive.cullMode         = wgpu::CullMode::None;
+    d.desc.fragment = &d.fragment;
+}
+
+pipelineVariants::slot *pipelineVariants::find(const variant &v)
+{
+    for(slot &s : slots)
+        if(s.state != Empty && s.v == v) return &s;
+    return nullptr;
+}
+
+pipelineVariants::slot *pipelineVariants::evict()
+{
+    slot *oldest = nullptr;
+    for(slot &s : slots) {
+        if(s.state == Empty) return &s;
+        if(s.state != Building && (!oldest || s.used < oldest->used)) oldest = &s;
+    }
+    if(!oldest) return nullptr;         // cacheSize builds in flight: their callbacks own the slots
+    oldest->pipeline = nullptr;
+    oldest->state = Empty;
+    return oldest;
+}
+
+wgpu::RenderPipeline pipelineVariants::create(const variant &v)
+{
+    slot *s = find(v);
+    if(s && s->state == Ready) { s->used = ++requests; return s->pipeline; }
+
+    descriptor d;
+    describe(d, v);
+    wgpu::RenderPipeline pipeline = device.CreateRenderPipeline(&d.desc);
+    if(!s) s = evict();
+    if(s && s->state != Building) {         // a build in flight keeps its slot
+        s->v        = v;
+        s->pipeline = pipeline;
+        s->state    = Ready;
+        s->used     = ++requests;
+    }
+    return pipeline;
+}
+
+const wgpu::RenderPipeline *pipelineVariants::request(const variant &v)
+{
+    slot *s = find(v);
+    if(s) {
+        s->used = ++requests;
+        return s->state == Ready ? &s->pipeline : nullptr;
+    }
+
+    s = evict();
+    if(!s) return nullptr;              // asked again next frame
+    s->v     = v;
+    s->used  = ++requests;
+    s->state = Building;
+    descriptor d;
+    describe(d, v);
+#if defined(__EMSCRIPTEN__)
+    device.CreateRenderPipelineAsync(&d.desc, [](WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline, const char *message, void *userdata) {
+        slot *self = (slot *) userdata;
+        if(status == WGPUCreatePipelineAsyncStatus_Success) { self->pipeline = wgpu::RenderPipeline::Acquire(pipeline); self->state = Ready; }
+        else { printf("fs() variant: %s\n", message ? message : ""); self->state = Failed; }
+    }, s);
+#else
+    device.CreateRenderPipelineAsync(&d.desc, wgpu::CallbackMode::AllowSpontaneous,
+                                     [](wgpu::CreatePipelineAsyncStatus status, wgpu::RenderPipeline pipeline, wgpu::StringView message, slot *self) {
+                                         if(status == wgpu::CreatePipelineAsyncStatus::Success) { self->pipeline = std::move(pipeline); self->state = Ready; }
+                                         else { printf("fs() variant: %s\n", message.data); self->state = Failed; }
+                                     }, s);
+#endif
+    return nullptr;
+}
+
+bool pipelineVariants::failed(const variant &v)
+{
+    slot *s = find(v);
+    if(!s || s->state != Failed) return false;
+    s->pipeline = nullptr;
+    s->state    = Empty;
+    return true;
+}
+
+bool pipelineVariants::isBuilding() const
+{
+    for(const slot &s : slots)
+        if(s.state == Building) return true;
+    return false;
+}
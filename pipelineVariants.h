@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  fs() render pipelines specialised by the override constants of mandel.wgsl
+//  (escapeRadius, unroll, smoothColor, power) through FragmentState::constants
+//   - small cache (cacheSize, least recently requested evicted) of variants
+//   - create(): synchronous, for the first pipeline at startup
+//   - request(): a missing variant is built with CreateRenderPipelineAsync,
+//     the caller keeps drawing with its current pipeline until it's ready
+//   - failed(): a build that failed is reported once and forgotten, so the
+//     same variant can be requested again
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <atomic>
+
+#include "wgpuUtils.h"
+
+class pipelineVariants {
+public:
+    struct variant {
+        float   escapeRadius = 4.f;
+        int32_t unroll       = 1;
+        bool    smooth       = false;
+        int32_t power        = 2;
+        bool operator==(const variant &v) const {
+            return escapeRadius == v.escapeRadius && unroll == v.unroll && smooth == v.smooth && power == v.power;
+        }
+    };
+    static constexpr int cacheSize = 8;
+
+    // module: vs() / fs() of mandel.wgsl, layout and color format of the pipelines
+    void init(const wgpu::Device &device, const wgpu::ShaderModule &module, const wgpu::PipelineLayout &layout, wgpu::TextureFormat format);
+
+    wgpu::RenderPipeline create(const variant &v);
+    // pipeline of v if ready, nullptr while it's built (or if its creation failed)
+    const wgpu::RenderPipeline *request(const variant &v);
+    bool isBuilding() const;     // callbacks pending: keep ticking the device
+    // creation of v failed (message printed by the callback): true once, the slot is freed for a retry
+    bool failed(const variant &v);
+
+private:
+    enum { Empty, Building, Ready, Failed };
+    struct slot {
+        variant              v;
+        wgpu::RenderPipeline pipeline;
+        std::atomic<int>     state { Empty };
+        uint64_t             used = 0;
+    };
+    // descriptor and the states it points to
+    struct descriptor {
+        wgpu::ConstantEntry         constants[4];
+        wgpu::BlendState            blend;
+        wgpu::ColorTargetState      target;
+        wgpu::FragmentState         fragment;
+        wgpu::RenderPipelineDescriptor desc;
+    };
+    void describe(descriptor &d, const variant &v) const;
+    slot *find(const variant &v);
+    slot *evict();                          // empty slot, or the least recently used one not building (nullptr: none)
+
+    wgpu::Device         device;
+    wgpu::ShaderModule   module;
+    wgpu::PipelineLayout layout;
+    wgpu::TextureFormat  format = wgpu::TextureFormat::Undefined;
+    slot                 slots[cacheSize];
+    uint64_t             requests = 0;
+};
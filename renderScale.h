@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Adaptive render scale: size of the iteration grid (iteration texture of
+//  mandelCompute, perturbation and tile cache views) relative to the surface,
+//  colorize upscales it to the surface
+//   - while the view changes: PI controller on the GPU ms of the iteration pass
+//     (gpuTimer) against budgetMs, output clamped to minScale .. maxScale (the
+//     integral too: no windup against the limits)
+//   - quantized in steps of 1/16 with hysteresis: the grid is reallocated (and
+//     iterated from z = 0) only when the scale moves by a whole step
+//   - samples of the frames right after a reallocation are skipped (full
+//     compute of the new grid, not the cost of the interaction)
+//   - view still for settleMs: back to native resolution (scale 1)
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+class renderScale {
+public:
+    static constexpr float step = 1.f / 16;
+    static constexpr int   skipSamples = 4;         // gpuTimer::ringSize: readbacks in flight at a reallocation
+    static constexpr float settleMs = 150;
+    static constexpr float deadband = .2f;          // scale error: under budget up to ~30% of ms
+
+    bool  enabled  = false;
+    float budgetMs = 8;                             // GPU ms of the iteration pass while the view changes
+    float minScale = .25f, maxScale = 1;
+    float kp = .3f, ki = .15f;                      // per unit of relative scale error sqrt(budget / ms) - 1
+
+    // every drawn frame, before the iterations: ms < 0 no new sample, moving: view changed in this frame
+    // true if scale() changed (the iteration grid must be resized)
+    bool update(float ms, bool moving) {
+        const float previous = current;
+        const auto now = clock::now();
+        if(!enabled) current = 1;
+        else if(moving) {
+            lastMove = now;
+            if(ms >= 0 && skip > 0) skip--;
+            else if(ms >= 0) {
+                const float lo = std::min(minScale, maxScale), hi = std::max(minScale, maxScale);
+                // cost ~ pixels ~ scale^2: error of the scale that meets the budget, bounded (a stall is not a target)
+                float error = std::clamp(std::sqrt(budgetMs / std::max(ms, .01f)) - 1.f, -.5f, .5f);
+                if(error > 0 && error < deadband) error = 0;  // a bit under budget: on target, no limit cycle between two steps
+                integral = std::clamp(integral + ki * error, lo, hi);
+                const float output = std::clamp(integral + kp * error, lo, hi);
+                // hysteresis: a new step only when the output is more than a whole step away from the current one
+                if(std::fabs(output - current) > step) current = std::clamp(std::round(output / step) * step, lo, hi);
+            }
+        }
+        else if(current != 1 && std::chrono::duration<float, std::milli>(now - lastMove).count() > settleMs) {
+            current = 1;                                // view still: native resolution, next interaction from there
+            integral = std::min(1.f, std::max(minScale, maxScale));
+        }
+        if(current == previous) return false;
+        skip = skipSamples;
+        return true;
+    }
+
+    float scale() const { return current; }
+    // grid is scaled (render on demand: keep drawing until back to native resolution)
+    bool isScaled() const { return current != 1; }
+    uint32_t scaled(uint32_t size) const { return std::max(1u, uint32_t(float(size) * current + .5f)); }
+
+private:
+    using clock = std::chrono::steady_clock;
+    float             current = 1, integral = 1;
+    int               skip = 0;
+    clock::time_point lastMove = clock::now();
+};
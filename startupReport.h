@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Time to first frame: mark() at the end of each startup stage (instance,
+//  adapter, device, pipeline, ...), finish() at first present; print() the
+//  time of every stage and the total from process start (construction of the
+//  global object)
+//   - stages can overlap (device requested on another thread while the window
+//     and ImGui are created): mark() is thread-safe, print() lists the stages
+//     in time order with the time from start, the last one is the critical path
+//   - web: start is when main() code runs, after download and compile of the
+//     .js / .wasm; print() adds the time from navigation start and the size of
+//     both files (Resource Timing), the numbers to compare two builds
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdio>
+#include <chrono>
+#include <mutex>
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#endif
+
+class startupReport {
+public:
+    static constexpr int maxStages = 16;
+
+    void mark(const char *stage) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(count < maxStages) stages[count++] = { stage, clock::now() };
+    }
+    // last stage (first present): false if already finished
+    bool finish(const char *stage) {
+        if(finished) return false;
+        finished = true;
+        mark(stage);
+        return true;
+    }
+    bool isFinished() const { return finished; }
+
+    void print(FILE *f = stdout) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto ms = [this](clock::time_point t) { return std::chrono::duration<double, std::milli>(t - start).count(); };
+        // marks of one thread are already ordered: insertion sort of the few interleaved ones
+        stage sorted[maxStages];
+        for(int i = 0; i < count; i++) {
+            int j = i;
+            for(; j > 0 && sorted[j - 1].t > stages[i].t; j--) sorted[j] = sorted[j - 1];
+            sorted[j] = stages[i];
+        }
+        fprintf(f, "startup (ms from start):");
+        for(int i = 0; i < count; i++) fprintf(f, " %s %.1f%s", sorted[i].name, ms(sorted[i].t), i + 1 < count ? "," : "");
+        fprintf(f, " - total %.1f ms\n", count ? ms(sorted[count - 1].t) : 0.);
+#if defined(__EMSCRIPTEN__)
+        // transferSize: 0 if served from the cache, then the (compressed) body size
+        EM_ASM({
+            const bytes = (ext) => performance.getEntriesByType('resource').filter((r) => r.name.split('?')[0].endsWith(ext))
+                                              .reduce((sum, r) => sum + (r.transferSize || r.encodedBodySize || 0), 0);
+            console.log('startup (page): ' + performance.now().toFixed(1) + ' ms from navigation, .js ' + bytes('.js') +
+                        ' bytes, .wasm ' + bytes('.wasm') + ' bytes');
+        });
+#endif
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+    struct stage {
+        const char       *name;         // static string
+        clock::time_point t;
+    };
+    clock::time_point start = clock::now();
+    stage             stages[maxStages];
+    int               count = 0;
+    bool              finished = false;     // main thread only
+    mutable std::mutex mutex;
+};
@@ -0,0 +1,330 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include "tileCache.h"
+
+static const char *iterateShader = {
+    #include "mandel.wgsl"
+};
+static const char *tilesShader = {
+    #include "mandel_tiles.wgsl"
+};
+
+static constexpr uint64_t tileBytes   = uint64_t(tileCache::tileSize) * tileCache::tileSize * sizeof(float);  // R32Float
+static constexpr uint32_t maxPerRow   = 8192 / tileCache::tileSize;    // maxTextureDimension2D (default limit)
+
+void tileCache::init(const wgpu::Device &dev, const wgpu::Buffer &uboBuffer, uint64_t uboBytes)
+{
+    device  = dev;
+    ubo     = uboBuffer;
+    uboSize = uboBytes;
+
+    const std::string code = std::string(iterateShader) + tilesShader;
+    wgpu::ShaderModule module = createShaderModule(device, code.c_str(), "mandelTiles");
+
+    // tiles: @binding(0) shaderData, (12) atlas (write), (13) jobs, (15) tileData
+    {
+        wgpu::BindGroupLayoutEntry entries[4];
+        const uint32_t bindings[4] = { 0, 12, 13, 15 };
+        for(int i = 0; i < 4; i++) { entries[i].binding = bindings[i]; entries[i].visibility = wgpu::ShaderStage::Compute; }
+        entries[0].buffer.type                  = wgpu::BufferBindingType::Uniform;
+        entries[0].buffer.minBindingSize        = uboSize;
+        entries[1].storageTexture.access        = wgpu::StorageTextureAccess::WriteOnly;
+        entries[1].storageTexture.format        = wgpu::TextureFormat::R32Float;
+        entries[1].storageTexture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[2].buffer.type                  = wgpu::BufferBindingType::ReadOnlyStorage;
+        entries[3].buffer.type                  = wgpu::BufferBindingType::Uniform;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 4;
+        bindGroupLayoutDesc.entries = entries;
+        tileLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &tileLayout;
+
+        wgpu::ComputePipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.compute.module = module;
+        descPipeline.compute.entryPoint = "csTile";
+        tilePipeline = device.CreateComputePipeline(&descPipeline);
+    }
+
+    // composite: @binding(1) iteration texture (write), (14) tile table, (15) tileData, (16) atlas (read)
+    {
+        wgpu::BindGroupLayoutEntry entries[4];
+        const uint32_t bindings[4] = { 1, 14, 15, 16 };
+        for(int i = 0; i < 4; i++) { entries[i].binding = bindings[i]; entries[i].visibility = wgpu::ShaderStage::Compute; }
+        entries[0].storageTexture.access        = wgpu::StorageTextureAccess::WriteOnly;
+        entries[0].storageTexture.format        = wgpu::TextureFormat::R32Float;
+        entries[0].storageTexture.viewDimension = wgpu::TextureViewDimension::e2D;
+        entries[1].buffer.type                  = wgpu::BufferBindingType::ReadOnlyStorage;
+        entries[2].buffer.type                  = wgpu::BufferBindingType::Uniform;
+        entries[3].texture.sampleType           = wgpu::TextureSampleType::UnfilterableFloat;
+        entries[3].texture.viewDimension        = wgpu::TextureViewDimension::e2D;
+
+        wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+        bindGroupLayoutDesc.entryCount = 4;
+        bindGroupLayoutDesc.entries = entries;
+        compositeLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+
+        wgpu::PipelineLayoutDescriptor layoutDesc;
+        layoutDesc.bindGroupLayoutCount = 1;
+        layoutDesc.bindGroupLayouts = &compositeLayout;
+
+        wgpu::ComputePipelineDescriptor descPipeline;
+        descPipeline.layout = device.CreatePipelineLayout(&layoutDesc);
+        descPipeline.compute.module = module;
+        descPipeline.compute.entryPoint = "csComposite";
+        compositePipeline = device.CreateComputePipeline(&descPipeline);
+    }
+
+    tileUbo = createBuffer(device, "tileData", wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, sizeof(uniformData));
+    for(asyncReadback &rb : readbacks) rb.create(device, tileBytes, "tileReadback");
+}
+
+void tileCache::setBudget(uint32_t megaBytes)
+{
+    if(megaBytes == budgetMB) return;
+    budgetMB = megaBytes;
+    if(atlasTexture) allocateAtlas();
+}
+
+void tileCache::release()
+{
+    if(!atlasTexture) return;
+    atlasTexture = nullptr;
+    atlasView    = nullptr;
+    tileBindGroup = compositeBindGroup = nullptr;
+    cache.clear();
+    lru.clear();
+    freeSlots.clear();
+    storeQueue.clear();
+    st.resident = st.capacity = 0;
+}
+
+void tileCache::allocateAtlas()
+{
+    slots  = uint32_t(std::clamp<uint64_t>(uint64_t(budgetMB) * 1024 * 1024 / tileBytes, 1, maxPerRow * maxPerRow));
+    perRow = std::min(maxPerRow, uint32_t(std::ceil(std::sqrt(double(slots)))));
+
+    wgpu::TextureDescriptor descTexture;
+    descTexture.label         = "tileAtlas";
+    descTexture.usage         = wgpu::TextureUsage::StorageBinding | wgpu::TextureUsage::TextureBinding |
+                                wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::CopySrc;        // tileStore upload / readback
+    descTexture.dimension     = wgpu::TextureDimension::e2D;
+    descTexture.size          = { perRow * tileSize, (slots + perRow - 1) / perRow * tileSize, 1 };
+    descTexture.format        = wgpu::TextureFormat::R32Float;
+    descTexture.mipLevelCount = 1;
+    descTexture.sampleCount   = 1;
+    atlasTexture = device.CreateTexture(&descTexture);
+    atlasView    = atlasTexture.CreateView();
+
+    // cache dropped: every slot free (and the tiles still to store)
+    cache.clear();
+    storeQueue.clear();
+    lru.clear();
+    freeSlots.resize(slots);
+    for(uint32_t i = 0; i < slots; i++) freeSlots[i] = slots - 1 - i;     // pop_back() gives slot 0 first
+    st.resident = 0;
+    st.capacity = slots;
+    tileBindGroup = compositeBindGroup = nullptr;
+}
+
+uint32_t tileCache::acquireSlot()
+{
+    if(!freeSlots.empty()) {
+        const uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    // least recently used: never a tile of the current frame (visible tiles <= slots, touched first)
+    auto it = cache.find(lru.back());
+    const uint32_t slot = it->second.slot;
+    cache.erase(it);
+    lru.pop_back();
+    st.evictions++;
+    return slot;
+}
+
+void tileCache::createBindGroups(const wgpu::TextureView &iterationView)
+{
+    wgpu::BindGroupEntry tileEntries[4];
+    tileEntries[0].binding = 0;  tileEntries[0].buffer = ubo;       tileEntries[0].size = uboSize;
+    tileEntries[1].binding = 12; tileEntries[1].textureView = atlasView;
+    tileEntries[2].binding = 13; tileEntries[2].buffer = jobBuffer; tileEntries[2].size = wgpu::kWholeSize;
+    tileEntries[3].binding = 15; tileEntries[3].buffer = tileUbo;   tileEntries[3].size = sizeof(uniformData);
+
+    wgpu::BindGroupDescriptor descBindGroup;
+    descBindGroup.layout     = tileLayout;
+    descBindGroup.entryCount = 4;
+    descBindGroup.entries    = tileEntries;
+    tileBindGroup = device.CreateBindGroup(&descBindGroup);
+
+    wgpu::BindGroupEntry compositeEntries[4];
+    compositeEntries[0].binding = 1;  compositeEntries[0].textureView = iterationView;
+    compositeEntries[1].binding = 14; compositeEntries[1].buffer = tableBuffer; compositeEntries[1].size = wgpu::kWholeSize;
+    compositeEntries[2].binding = 15; compositeEntries[2].buffer = tileUbo;     compositeEntries[2].size = sizeof(uniformData);
+    compositeEntries[3].binding = 16; compositeEntries[3].textureView = atlasView;
+
+    descBindGroup.layout  = compositeLayout;
+    descBindGroup.entries = compositeEntries;
+    compositeBindGroup = device.CreateBindGroup(&descBindGroup);
+    boundView = iterationView.Get();
+}
+
+bool tileCache::render(const wgpu::CommandEncoder &encoder, double cx, double cy, double sx, double sy, uint32_t w, uint32_t h,
+                       int32_t iterations, int32_t interior, const wgpu::TextureView &iterationView, const computeTimestampWrites *timestamps)
+{
+    if(!device || !w || !h) return false;
+    if(!atlasTexture) allocateAtlas();          // first use: VRAM only while the cache is enabled
+
+    // coarsest level with tile pixel <= view pixel (level 0 may be larger: view wider than the set)
+    const double pixel = 2. * sy / double(h);
+    const int level = std::max(0, int(std::ceil(std::log2(levelStep0 / pixel))));
+    if(level > maxLevel) return false;
+    const double step = std::ldexp(levelStep0, -level), span = step * tileSize;
+
+    const double x0 = cx - sx, y0 = cy - sy;
+    const int32_t tx0 = int32_t(std::floor(x0 / span)),        ty0 = int32_t(std::floor(y0 / span));
+    const int32_t tx1 = int32_t(std::floor((cx + sx) / span)), ty1 = int32_t(std::floor((cy + sy) / span));
+    const uint32_t cols = uint32_t(tx1 - tx0 + 1), rows = uint32_t(ty1 - ty0 + 1);
+    if(uint64_t(cols) * rows > slots) return false;
+
+    st.level = level;
+    table.assign(cols * rows, ~0u);
+    jobs.clear();
+    jobKeys.clear();
+    wgpu::Queue queue = device.GetQueue();
+
+    // hits first: touched tiles go to the front of LRU, misses can't evict them
+    for(uint32_t j = 0; j < rows; j++)
+        for(uint32_t i = 0; i < cols; i++) {
+            auto it = cache.find({ level, tx0 + int32_t(i), ty0 + int32_t(j), iterations, interior });
+            if(it == cache.end()) continue;
+            lru.splice(lru.begin(), lru, it->second.lru);
+            table[j * cols + i] = it->second.slot;
+            st.hits++;
+        }
+    for(uint32_t j = 0; j < rows; j++)
+        for(uint32_t i = 0; i < cols; i++) {
+            if(table[j * cols + i] != ~0u) continue;
+            const key k = { level, tx0 + int32_t(i), ty0 + int32_t(j), iterations, interior };
+            const uint32_t slot = acquireSlot();
+            lru.push_front(k);
+            cache[k] = { slot, lru.begin() };
+            table[j * cols + i] = slot;
+            st.misses++;
+            // stored: uploaded straight from the file mapping, no iterations
+            if(const float *stored = store ? store->find(k) : nullptr) {
+                texelCopyTexture dst;
+                dst.texture  = atlasTexture;
+                dst.origin   = { slot % perRow * tileSize, slot / perRow * tileSize, 0 };
+                texelCopyBufferLayout layout;
+                layout.bytesPerRow  = tileSize * sizeof(float);
+                layout.rowsPerImage = tileSize;
+                const wgpu::Extent3D size = { tileSize, tileSize, 1 };
+                queue.WriteTexture(&dst, stored, tileBytes, &layout, &size);
+                st.loads++;
+                continue;
+            }
+            jobs.push_back({ { float(double(k.x) * span), float(double(k.y) * span) }, slot, 0 });
+            jobKeys.push_back(k);
+        }
+    st.resident  = uint32_t(cache.size());
+    missingTiles = uint32_t(jobs.size());
+
+    // buffers grow (power of 2) with the visible tiles
+    bool rebind = !tileBindGroup || boundView != iterationView.Get();
+    auto grow = [&](wgpu::Buffer &buffer, uint32_t &capacity, uint32_t count, uint64_t elemSize, const char *label) {
+        if(buffer && count <= capacity) return;
+        capacity = 64;
+        while(capacity < count) capacity *= 2;
+        buffer = createBuffer(device, label, wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage, capacity * elemSize);
+        rebind = true;
+    };
+    grow(jobBuffer,   jobCapacity,   std::max(1u, missingTiles), sizeof(job),      "tileJobs");
+    grow(tableBuffer, tableCapacity, cols * rows,                sizeof(uint32_t), "tileTable");
+    if(rebind) createBindGroups(iterationView);
+
+    const uniformData ud = { { float((double(tx0) * span - x0) / pixel), float((double(ty0) * span - y0) / pixel) },
+                             float(pixel / step), float(step), cols, rows, perRow, 0 };
+    queue.WriteBuffer(tileUbo, 0, &ud, sizeof(uniformData));
+    queue.WriteBuffer(tableBuffer, 0, table.data(), table.size() * sizeof(uint32_t));
+    if(missingTiles) queue.WriteBuffer(jobBuffer, 0, jobs.data(), jobs.size() * sizeof(job));
+
+    wgpu::ComputePassDescriptor descPass;
+    descPass.timestampWrites = timestamps;
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&descPass);
+    if(missingTiles) {
+        pass.SetPipeline(tilePipeline);
+        pass.SetBindGroup(0, tileBindGroup, 0, nullptr);
+        pass.DispatchWorkgroups(tileSize / 8, tileSize / 8, missingTiles);      // @workgroup_size(8, 8), one tile per z
+    }
+    pass.SetPipeline(compositePipeline);
+    pass.SetBindGroup(0, compositeBindGroup, 0, nullptr);
+    pass.DispatchWorkgroups((w + 7) / 8, (h + 7) / 8, 1);
+    pass.End();
+
+    // new tiles -> store: read back by storeTiles(), in this frame and the next ones
+    if(store) storeQueue.insert(storeQueue.end(), jobKeys.begin(), jobKeys.end());
+    return true;
+}
+
+void tileCache::storeTiles(const wgpu::CommandEncoder &encoder)
+{
+    // free readbacks only: the frame never waits
+    for(int rb = 0; store && !storeQueue.empty() && rb < readbackCount; ) {
+        if(!readbacks[rb].isIdle()) { rb++; continue; }
+        const key k = storeQueue.front();
+        storeQueue.pop_front();
+        auto it = cache.find(k);
+        if(it == cache.end() || store->contains(k)) continue;     // evicted (computed again when missed) or already stored
+        const uint32_t slot = it->second.slot;
+
+        texelCopyTexture src;
+        src.texture = atlasTexture;
+        src.origin  = { slot % perRow * tileSize, slot / perRow * tileSize, 0 };
+        texelCopyBuffer dst;
+        dst.buffer              = readbacks[rb].getBuffer();
+        dst.layout.bytesPerRow  = tileSize * sizeof(float);     // 1024: multiple of 256
+        dst.layout.rowsPerImage = tileSize;
+        const wgpu::Extent3D size = { tileSize, tileSize, 1 };
+        encoder.CopyTextureToBuffer(&src, &dst, &size);
+        readbacks[rb].markCopied();
+        readbackKeys[rb] = k;
+    }
+}
+
+void tileCache::afterSubmit()
+{
+    if(!store) return;
+    for(int i = 0; i < readbackCount; i++) {
+        if(readbacks[i].isMapped()) store->append(readbackKeys[i], (const float *) readbacks[i].data());   // copied: writer thread does I/O
+        readbacks[i].release();
+        readbacks[i].requestMap();
+    }
+    store->poll();
+}
+
+bool tileCache::storePending() const
+{
+    if(store && !storeQueue.empty()) return true;
+    for(const asyncReadback &rb : readbacks)
+        if(!rb.isIdle()) return true;
+    return false;
+}
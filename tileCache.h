@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  GPU tile cache pyramid (f32): smooth counts of tileSize x tileSize tiles
+//  kept in an R32Float atlas texture, keyed by (level, tile x, tile y,
+//  iterations, interior checks), LRU eviction under a VRAM budget
+//   - level L: tile pixel of levelStep0 / 2^L complex units, the view uses the
+//     coarsest level whose pixel is not larger than its own (1 .. 2 tile
+//     pixels per view pixel), tiles on a fixed grid from c = 0
+//   - render(): missing tiles are computed (csTile, mandel_tiles.wgsl), then
+//     the iteration texture is composited from the atlas (csComposite):
+//     zooming within a level or back to a visited region computes nothing
+//   - budget: atlas of (budget / tile bytes) slots, setBudget() drops the cache
+//   - the atlas is allocated at the first render(), release() frees it (cache
+//     disabled): no VRAM while the cache is off
+//   - optional tileStore (disk): misses found there are uploaded from its
+//     mapping instead of computed, computed tiles are queued and read back a
+//     few per frame (storeTiles(), asyncReadback) and appended to it
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "wgpuUtils.h"
+#include "tileStore.h"
+
+class tileCache {
+public:
+    static constexpr uint32_t tileSize   = 256;          // as mandel_tiles.wgsl
+    static constexpr double   levelStep0 = 4. / tileSize; // level 0: one tile covers 4 x 4 (|c| <= 2)
+    static constexpr int      maxLevel   = 24;            // beyond f32 resolution anyway
+
+    struct stats {
+        uint64_t hits = 0, misses = 0, evictions = 0;
+        uint64_t loads = 0;                             // misses uploaded from the store
+        uint32_t resident = 0, capacity = 0;
+        int      level = 0;
+    };
+
+    // ubo: shaderData_ of the examples (iterations, interior checks)
+    void init(const wgpu::Device &device, const wgpu::Buffer &ubo, uint64_t uboSize);
+    void setBudget(uint32_t megaBytes);                 // reallocates the atlas (if allocated): cache dropped
+    void release();                                     // frees the atlas, cache dropped: next render() allocates it again
+    uint32_t budget() const { return budgetMB; }
+    void setStore(tileStore *diskStore) { store = diskStore; }   // nullptr: no disk store
+
+    // view: center, half size (as mandelPerturb), w x h = iteration texture size
+    // false: view not cacheable (pixel beyond maxLevel, or more visible tiles than slots), nothing encoded
+    bool render(const wgpu::CommandEncoder &encoder, double cx, double cy, double sx, double sy, uint32_t w, uint32_t h,
+                int32_t iterations, int32_t interior, const wgpu::TextureView &iterationView, const computeTimestampWrites *timestamps = nullptr);
+
+    // every frame (also without render()): queued tiles still resident -> free readbacks
+    void storeTiles(const wgpu::CommandEncoder &encoder);
+    // after queue.Submit(): tiles read back -> store
+    void afterSubmit();
+    bool storePending() const;                          // tiles queued or readbacks not completed (render on demand)
+
+    const stats &counters() const { return st; }
+    uint32_t lastMissing() const { return missingTiles; }   // tiles computed by last render()
+
+private:
+    using key     = tileStore::key;
+    using keyHash = tileStore::keyHash;
+    struct entry {
+        uint32_t slot;
+        std::list<key>::iterator lru;
+    };
+    // must match tileData / tileJob in mandel_tiles.wgsl
+    struct uniformData {
+        float    gridOrigin[2];
+        float    ratio, step;
+        uint32_t cols, rows, perRow, pad;
+    };
+    struct job {
+        float    c0[2];
+        uint32_t slot, pad;
+    };
+
+    void allocateAtlas();
+    void createBindGroups(const wgpu::TextureView &iterationView);
+    uint32_t acquireSlot();                     // free slot, or the least recently used one
+
+    wgpu::Device          device;
+    wgpu::Buffer          ubo;
+    uint64_t              uboSize = 0;
+    wgpu::ComputePipeline tilePipeline, compositePipeline;
+    wgpu::BindGroupLayout tileLayout, compositeLayout;
+    wgpu::BindGroup       tileBindGroup, compositeBindGroup;
+    WGPUTextureView       boundView = nullptr;  // iteration texture of compositeBindGroup
+    wgpu::Texture         atlasTexture;
+    wgpu::TextureView     atlasView;
+    wgpu::Buffer          tileUbo, jobBuffer, tableBuffer;
+    uint32_t              jobCapacity = 0, tableCapacity = 0;
+
+    uint32_t              budgetMB = 256, perRow = 0, slots = 0;
+    std::unordered_map<key, entry, keyHash> cache;
+    std::list<key>        lru;                  // front: most recently used
+    std::vector<uint32_t> freeSlots;
+    uint32_t              missingTiles = 0;
+    stats                 st;
+    std::vector<uint32_t> table;
+    std::vector<job>      jobs;
+
+    // computed tiles -> store: queued, one tile per readback (evicted before their turn: dropped)
+    static constexpr int  readbackCount = 4;
+    tileStore            *store = nullptr;
+    asyncReadback         readbacks[readbackCount];
+    key                   readbackKeys[readbackCount];
+    std::vector<key>      jobKeys;
+    std::deque<key>       storeQueue;
+};
@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include "tilePool.h"
+
+#include <chrono>
+#include <algorithm>
+
+using clockType = std::chrono::steady_clock;
+
+//------------------------------------------------------------------------------
+// Chase-Lev deque (no push during a run)
+//------------------------------------------------------------------------------
+bool tilePool::worker::pop(uint32_t &tile)
+{
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if(t > b) {                         // empty
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    tile = tiles[size_t(b)];
+    if(t == b) {                        // last element: race against thieves
+        const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+bool tilePool::worker::steal(uint32_t &tile)
+{
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+    if(t >= b) return false;            // empty
+
+    tile = tiles[size_t(t)];
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Pool
+//------------------------------------------------------------------------------
+tilePool::tilePool(unsigned numThreads)
+{
+    if(!numThreads) numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    workers.resize(numThreads);
+    for(unsigned i = 0; i < numThreads; i++) {
+        workers[i] = std::make_unique<worker>();
+        workers[i]->rng = 0x9E3779B9u * (i + 1);
+    }
+    // worker 0 is the thread that calls run()
+    for(unsigned i = 1; i < numThreads; i++)
+        workers[i]->thread = std::thread(&tilePool::workerLoop, this, i);
+}
+
+tilePool::~tilePool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        quit = true;
+    }
+    startCV.notify_all();
+    for(auto &w : workers)
+        if(w->thread.joinable()) w->thread.join();
+}
+
+void tilePool::run(uint32_t tileCount, const jobFunc &job)
+{
+    auto start = clockType::now();
+    const unsigned n = size();
+
+    // contiguous blocks: neighbour tiles (similar cost, shared cache lines) stay on the same core,
+    // the imbalance is resolved by stealing
+    for(unsigned i = 0; i < n; i++) {
+        worker &w = *workers[i];
+        const uint32_t first = uint32_t(uint64_t(tileCount) *  i      / n);
+        const uint32_t last  = uint32_t(uint64_t(tileCount) * (i + 1) / n);
+        w.tiles.resize(last - first);
+        for(uint32_t t = first; t < last; t++) w.tiles[t - first] = last - 1 - (t - first);   // owner pops first tile first
+        w.top.store(0, std::memory_order_relaxed);
+        w.bottom.store(int64_t(w.tiles.size()), std::memory_order_relaxed);
+        w.stats = workerStats();
+    }
+    currentJob = &job;
+    remaining.store(tileCount, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running.store(n - 1, std::memory_order_relaxed);
+        generation++;
+    }
+    startCV.notify_all();
+
+    execute(0);
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        doneCV.wait(lock, [this] { return running.load(std::memory_order_acquire) == 0; });
+    }
+    currentJob = nullptr;
+    runSeconds = std::chrono::duration<double>(clockType::now() - start).count();
+}
+
+void tilePool::workerLoop(unsigned idx)
+{
+    uint64_t seenGeneration = 0;
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            startCV.wait(lock, [&] { return quit || generation != seenGeneration; });
+            if(quit) return;
+            seenGeneration = generation;
+        }
+
+        execute(idx);
+
+        if(running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mtx);
+            doneCV.notify_one();
+        }
+    }
+}
+
+void tilePool::execute(unsigned idx)
+{
+    worker &me = *workers[idx];
+    const unsigned n = size();
+
+    while(remaining.load(std::memory_order_acquire) > 0) {
+        uint32_t tile;
+        bool found = me.pop(tile);
+        if(!found && n > 1) {
+            // one round over all the other workers, starting from a random victim
+            me.rng ^= me.rng << 13; me.rng ^= me.rng >> 17; me.rng ^= me.rng << 5;
+            const unsigned first = me.rng % n;
+            for(unsigned k = 0; k < n && !found; k++) {
+                const unsigned victim = (first + k) % n;
+                if(victim == idx) continue;
+                found = workers[victim]->steal(tile);
+                if(found) me.stats.steals++;
+                else      me.stats.failedSteals++;
+            }
+        }
+        if(!found) { std::this_thread::yield(); continue; }     // last tiles are still running elsewhere
+
+        auto start = clockType::now();
+        (*currentJob)(tile, idx);
+        me.stats.busySeconds += std::chrono::duration<double>(clockType::now() - start).count();
+        me.stats.tiles++;
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Work-stealing thread pool for tile rendering
+//  Escape-time cost is very uneven (cardioid tiles run all iterations, exterior
+//  tiles bail out in few steps): every worker owns a deque of tiles, pops from
+//  its bottom (LIFO, cache friendly) and, when empty, steals from the top of a
+//  random victim (Chase-Lev protocol, lock-free)
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <memory>
+
+class tilePool {
+public:
+    struct workerStats {
+        uint64_t tiles         = 0;     // tiles executed
+        uint64_t steals        = 0;     // tiles taken from other workers
+        uint64_t failedSteals  = 0;     // steal attempts on empty deque or lost race
+        double   busySeconds   = 0;     // time spent inside jobs
+    };
+
+    // job(tile, worker): tile in [0, tileCount), worker in [0, size())
+    using jobFunc = std::function<void(uint32_t tile, unsigned worker)>;
+
+    explicit tilePool(unsigned numThreads = 0);     // 0: std::thread::hardware_concurrency()
+    ~tilePool();
+
+    tilePool(const tilePool &) = delete;
+    tilePool &operator=(const tilePool &) = delete;
+
+    // execute job for all tiles and wait them: the caller thread works as worker 0
+    void run(uint32_t tileCount, const jobFunc &job);
+
+    unsigned size() const { return unsigned(workers.size()); }
+
+    // counters of the last run()
+    const workerStats &stats(unsigned worker) const { return workers[worker]->stats; }
+    double lastRunSeconds() const { return runSeconds; }
+
+private:
+    // bounded Chase-Lev deque: tiles are all pushed before the run, so no resize
+    struct alignas(64) worker {
+        std::vector<uint32_t> tiles;
+        alignas(64) std::atomic<int64_t> top    { 0 };
+        alignas(64) std::atomic<int64_t> bottom { 0 };
+        workerStats stats;
+        uint32_t rng = 0;
+        std::thread thread;
+
+        bool pop(uint32_t &tile);
+        bool steal(uint32_t &tile);
+    };
+
+    void workerLoop(unsigned idx);
+    void execute(unsigned idx);
+
+    std::vector<std::unique_ptr<worker>> workers;
+    const jobFunc *currentJob = nullptr;
+    alignas(64) std::atomic<uint32_t> remaining { 0 };   // tiles not yet completed
+    std::atomic<unsigned> running { 0 };                 // helper threads still inside execute()
+
+    std::mutex mtx;
+    std::condition_variable startCV, doneCV;
+    uint64_t generation = 0;
+    bool quit = false;
+    double runSeconds = 0;
+};
@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "tileStore.h"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define TILE_STORE_POSIX
+#endif
+
+static const char     storeMagic[8] = { 'M', 'A', 'N', 'D', 'T', 'I', 'L', 'E' };
+static const uint32_t storeVersion  = 2;    // 2: interior in the key
+static const uint32_t recordMagic   = 0x454c4954;       // "TILE"
+
+#if defined(TILE_STORE_POSIX)
+static bool writeAll(int fd, const void *data, size_t bytes, uint64_t offset)
+{
+    const uint8_t *p = (const uint8_t *) data;
+    while(bytes) {
+        const ssize_t n = pwrite(fd, p, bytes, off_t(offset));
+        if(n <= 0) return false;
+        p += n; bytes -= size_t(n); offset += uint64_t(n);
+    }
+    return true;
+}
+#endif
+
+bool tileStore::open(const char *path, uint32_t tileSize, uint64_t maxBytes)
+{
+    close();
+#if defined(TILE_STORE_POSIX)
+    payloadBytes = uint64_t(tileSize) * tileSize * sizeof(float);
+    recordBytes  = sizeof(recordHeader) + payloadBytes;
+
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if(fd < 0) { printf("tile store: can't open %s\n", path); return false; }
+
+    struct stat sb;
+    fstat(fd, &sb);
+    fileHeader hdr = {};
+    if(sb.st_size == 0) {           // new store
+        memcpy(hdr.magic, storeMagic, sizeof(storeMagic));
+        hdr.version = storeVersion; hdr.tileSize = tileSize; hdr.recordBytes = uint32_t(recordBytes);
+        if(!writeAll(fd, &hdr, sizeof(hdr), 0)) { printf("tile store: can't write %s\n", path); ::close(fd); fd = -1; return false; }
+        sb.st_size = sizeof(hdr);
+    }
+    else if(pread(fd, &hdr, sizeof(hdr), 0) != ssize_t(sizeof(hdr)) || memcmp(hdr.magic, storeMagic, sizeof(storeMagic)) ||
+            hdr.version != storeVersion || hdr.tileSize != tileSize || hdr.recordBytes != recordBytes) {
+        printf("tile store: %s is not a store of %u x %u tiles (version %u)\n", path, tileSize, tileSize, storeVersion);
+        ::close(fd); fd = -1;
+        return false;
+    }
+
+    // mapped once for maxBytes: pages past the end of file are never touched (only written records)
+    mappedBytes = std::max<uint64_t>(maxBytes, uint64_t(sb.st_size));
+    void *m = mmap(nullptr, size_t(mappedBytes), PROT_READ, MAP_SHARED, fd, 0);
+    if(m == MAP_FAILED) { printf("tile store: can't map %s\n", path); ::close(fd); fd = -1; return false; }
+    mapping = (uint8_t *) m;
+
+    // index from the record headers, up to the first torn record
+    fileEnd = sizeof(fileHeader);
+    while(fileEnd + recordBytes <= uint64_t(sb.st_size)) {
+        const recordHeader *rh = (const recordHeader *) (mapping + fileEnd);
+        if(rh->magic != recordMagic) break;
+        index.emplace(rh->k, fileEnd);
+        fileEnd += recordBytes;
+    }
+
+    quit   = false;
+    writer = std::thread(&tileStore::writerLoop, this);
+    return true;
+#else
+    (void) tileSize; (void) maxBytes;
+    printf("tile store: %s not opened, mmap store not available on this platform\n", path);
+    return false;
+#endif
+}
+
+void tileStore::close()
+{
+#if defined(TILE_STORE_POSIX)
+    if(writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+        }
+        cv.notify_all();
+        writer.join();
+    }
+    if(mapping) munmap(mapping, size_t(mappedBytes));
+    if(fd >= 0) ::close(fd);
+#endif
+    mapping = nullptr;
+    fd = -1;
+    index.clear();
+    queuedKeys.clear();
+    queue.clear();
+    done.clear();
+}
+
+const float *tileStore::find(const key &k)
+{
+    auto it = index.find(k);
+    if(it == index.end()) return nullptr;
+    loaded++;
+    return (const float *) (mapping + it->second + sizeof(recordHeader));
+}
+
+bool tileStore::append(const key &k, const float *data)
+{
+    if(!isOpen() || contains(k)) return false;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if(queue.size() >= maxQueued) { dropped++; return false; }
+        queue.push_back({ k, std::vector<float>(data, data + payloadBytes / sizeof(float)) });
+    }
+    queuedKeys.insert(k);
+    cv.notify_one();
+    return true;
+}
+
+void tileStore::poll()
+{
+    std::vector<std::pair<key, uint64_t>> written;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        written.swap(done);
+    }
+    for(auto &w : written) {
+        queuedKeys.erase(w.first);
+        if(w.second != ~uint64_t(0)) index.emplace(w.first, w.second);     // ~0: write failed or file full
+    }
+}
+
+tileStore::stats tileStore::counters() const
+{
+    stats s;
+    s.records = index.size();
+    s.loaded  = loaded;
+    s.queued  = uint32_t(queuedKeys.size());
+    std::lock_guard<std::mutex> lock(mtx);
+    s.written = written;
+    s.dropped = dropped;
+    return s;
+}
+
+void tileStore::writerLoop()
+{
+#if defined(TILE_STORE_POSIX)
+    std::unique_lock<std::mutex> lock(mtx);
+    for(;;) {
+        cv.wait(lock, [this] { return quit || !queue.empty(); });
+        if(queue.empty()) return;           // quit: after the queued tiles
+        pendingTile tile = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        // payload first, header last: a record is valid only when complete
+        uint64_t offset = ~uint64_t(0);
+        if(fileEnd + recordBytes <= mappedBytes) {
+            const recordHeader rh = { recordMagic, tile.k, { 0, 0, 0 } };
+            if(writeAll(fd, tile.data.data(), size_t(payloadBytes), fileEnd + sizeof(recordHeader)) &&
+               writeAll(fd, &rh, sizeof(rh), fileEnd)) {
+                offset = fileEnd;
+                fileEnd += recordBytes;
+            }
+        }
+
+        lock.lock();
+        done.emplace_back(tile.k, offset);
+        if(offset != ~uint64_t(0)) written++;
+        else dropped++;
+    }
+#endif
+}
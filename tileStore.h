@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  On-disk tile store: tiles of tileCache survive restarts
+//   - append-only file: header + fixed-size records (key header + tileSize^2
+//     raw R32Float smooth counts), memory mapped read-only once for maxBytes:
+//     find() returns a pointer in the mapping, uploaded as is (WriteTexture)
+//   - index (key -> record) in memory, rebuilt at open() from the record
+//     headers: a record is valid only after its header is written (the
+//     payload first), a torn tail is ignored and overwritten
+//   - append(): queued to a writer thread (pwrite), the caller never waits
+//     for I/O; poll() moves written records into the index
+//   - POSIX only (mmap / pwrite): on Windows and Emscripten open() fails
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class tileStore {
+public:
+    // tile of the pyramid: level, tile x, tile y (grid from c = 0), iterations, interior checks (shaderData_)
+    struct key {
+        int32_t level, x, y, iterations, interior;
+        bool operator==(const key &k) const { return level == k.level && x == k.x && y == k.y && iterations == k.iterations && interior == k.interior; }
+    };
+    struct keyHash {
+        size_t operator()(const key &k) const {
+            uint64_t h = uint64_t(uint32_t(k.x)) * 0x9e3779b97f4a7c15ull ^ uint64_t(uint32_t(k.y)) * 0xc2b2ae3d27d4eb4full;
+            return size_t(h ^ (uint64_t(uint32_t(k.level)) << 40) ^ (uint64_t(uint32_t(k.interior)) << 56) ^
+                          uint64_t(uint32_t(k.iterations)) * 0x165667b19e3779f9ull);
+        }
+    };
+    struct stats {
+        uint64_t records = 0;       // in the index
+        uint64_t loaded = 0;        // find() hits
+        uint64_t written = 0, dropped = 0;  // appended by the writer / refused (queue full, file full)
+        uint32_t queued = 0;
+    };
+
+    tileStore() = default;
+    ~tileStore() { close(); }
+    tileStore(const tileStore &) = delete;
+    tileStore &operator=(const tileStore &) = delete;
+
+    // tileSize: pixels per side (R32Float), maxBytes: file size limit (appends beyond are dropped)
+    bool open(const char *path, uint32_t tileSize, uint64_t maxBytes = uint64_t(4) << 30);
+    void close();               // writes the queued tiles, then unmaps
+    bool isOpen() const { return mapping != nullptr; }
+
+    // main thread
+    const float *find(const key &k);                    // tileSize^2 smooth counts in the mapping, nullptr if not stored
+    bool contains(const key &k) const { return index.count(k) || queuedKeys.count(k); }
+    bool append(const key &k, const float *data);       // copied and queued: false if dropped
+    void poll();                                        // written records -> index
+
+    stats counters() const;
+
+private:
+    struct fileHeader {
+        char     magic[8];          // "MANDTILE"
+        uint32_t version, tileSize, recordBytes, pad;
+    };
+    struct recordHeader {
+        uint32_t magic;             // recordMagic: written after the payload
+        key      k;
+        uint32_t pad[3];
+    };
+    struct pendingTile {
+        key                k;
+        std::vector<float> data;
+    };
+
+    void writerLoop();
+
+    int         fd = -1;
+    uint8_t    *mapping = nullptr;
+    uint64_t    mappedBytes = 0, recordBytes = 0, payloadBytes = 0;
+    uint64_t    fileEnd = 0;        // next record offset: writer thread only after open()
+
+    std::unordered_map<key, uint64_t, keyHash> index;  // record offset
+    std::unordered_set<key, keyHash>           queuedKeys;
+    uint64_t    loaded = 0, dropped = 0;
+
+    // writer thread
+    std::thread                 writer;
+    mutable std::mutex          mtx;
+    std::condition_variable     cv;
+    std::deque<pendingTile>     queue;
+    std::vector<std::pair<key, uint64_t>> done;        // written, not yet in index
+    uint64_t                    written = 0;
+    bool                        quit = false;
+
+    static constexpr uint32_t maxQueued = 64;           // 16 MB of 256 x 256 tiles
+};
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Small helpers shared by the renderers: they hide the differences between
+//  DAWN (native) and EMSCRIPTEN (-sUSE_WEBGPU) WebGPU C++ bindings
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <webgpu/webgpu_cpp.h>
+
+inline wgpu::ShaderModule createShaderModule(const wgpu::Device &device, const char *code, const char *label = nullptr)
+{
+#if defined(__EMSCRIPTEN__)
+    wgpu::ShaderModuleWGSLDescriptor wgslDesc;
+    wgslDesc.code = code;
+#else
+    wgpu::ShaderSourceWGSL wgslDesc;
+    wgslDesc.code = { code, WGPU_STRLEN };
+#endif
+    wgpu::ShaderModuleDescriptor shaderDescriptor;
+    shaderDescriptor.nextInChain = &wgslDesc;
+    shaderDescriptor.label = label;
+    return device.CreateShaderModule(&shaderDescriptor);
+}
+
+// pass timestampWrites: DAWN has one type for compute and render passes, EMSCRIPTEN two
+#if defined(__EMSCRIPTEN__)
+using computeTimestampWrites = wgpu::ComputePassTimestampWrites;
+using renderTimestampWrites  = wgpu::RenderPassTimestampWrites;
+#else
+using computeTimestampWrites = wgpu::PassTimestampWrites;
+using renderTimestampWrites  = wgpu::PassTimestampWrites;
+#endif
+
+// queue.WriteTexture() / CopyTextureToBuffer() arguments: renamed in DAWN (TexelCopy*), EMSCRIPTEN has the old names
+#if defined(__EMSCRIPTEN__)
+using texelCopyTexture      = wgpu::ImageCopyTexture;
+using texelCopyBuffer       = wgpu::ImageCopyBuffer;
+using texelCopyBufferLayout = wgpu::TextureDataLayout;
+#else
+using texelCopyTexture      = wgpu::TexelCopyTextureInfo;
+using texelCopyBuffer       = wgpu::TexelCopyBufferInfo;
+using texelCopyBufferLayout = wgpu::TexelCopyBufferLayout;
+#endif
+
+// device limits: DAWN fills wgpu::Limits, EMSCRIPTEN wraps them in SupportedLimits
+inline wgpu::Limits getLimits(const wgpu::Device &device)
+{
+#if defined(__EMSCRIPTEN__)
+    wgpu::SupportedLimits supported;
+    device.GetLimits(&supported);
+    return supported.limits;
+#else
+    wgpu::Limits limits;
+    device.GetLimits(&limits);
+    return limits;
+#endif
+}
+
+inline wgpu::Buffer createBuffer(const wgpu::Device &device, const char *label, wgpu::BufferUsage usage, uint64_t size)
+{
+    wgpu::BufferDescriptor bufferDesc;
+    bufferDesc.label = label;
+    bufferDesc.usage = usage;
+    bufferDesc.size  = (size + 3) & ~uint64_t(3);   // WriteBuffer/ClearBuffer need multiple of 4
+    return device.CreateBuffer(&bufferDesc);
+}
+
+// GPU -> CPU readback that never stalls the frame: copy in the frame encoder, map after Submit,
+// read it in a next frame only when the map is completed (otherwise the copy is skipped)
+class asyncReadback {
+public:
+    enum { Idle, Copied, Pending, Mapped, Failed };
+
+    void create(const wgpu::Device &device, uint64_t bytes, const char *label = "readback") {
+        size   = (bytes + 3) & ~uint64_t(3);
+        buffer = createBuffer(device, label, wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead, size);
+        state  = Idle;
+    }
+
+    bool isIdle()   const { return state == Idle; }
+    bool isMapped() const { return state == Mapped; }
+
+    // record the copy (only if the buffer is free)
+    bool copyFrom(const wgpu::CommandEncoder &encoder, const wgpu::Buffer &src, uint64_t srcOffset = 0) {
+        if(state != Idle) return false;
+        encoder.CopyBufferToBuffer(src, srcOffset, buffer, 0, size);
+        state = Copied;
+        return true;
+    }
+    void markCopied() { if(state == Idle) state = Copied; }     // copy recorded elsewhere (e.g. ResolveQuerySet + copy)
+
+    // after queue.Submit()
+    void requestMap() {
+        if(state != Copied) return;
+        state = Pending;
+#if defined(__EMSCRIPTEN__)
+        buffer.MapAsync(wgpu::MapMode::Read, 0, size, [](WGPUBufferMapAsyncStatus status, void *userdata) {
+            ((asyncReadback *) userdata)->state = status == WGPUBufferMapAsyncStatus_Success ? Mapped : Failed;
+        }, this);
+#else
+        buffer.MapAsync(wgpu::MapMode::Read, 0, size, wgpu::CallbackMode::AllowSpontaneous,
+                        [](wgpu::MapAsyncStatus status, wgpu::StringView, asyncReadback *self) {
+                            self->state = status == wgpu::MapAsyncStatus::Success ? Mapped : Failed;
+                        }, this);
+#endif
+    }
+
+    const void *data() const { return state == Mapped ? buffer.GetConstMappedRange(0, size) : nullptr; }
+
+    // done with data(): buffer can be used for next copy
+    void release() {
+        if(state == Mapped) buffer.Unmap();
+        if(state == Mapped || state == Failed) state = Idle;
+    }
+
+    const wgpu::Buffer &getBuffer() const { return buffer; }
+
+private:
+    wgpu::Buffer buffer;
+    uint64_t size = 0;
+    std::atomic<int> state { Idle };
+};
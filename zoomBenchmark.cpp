@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "zoomBenchmark.h"
+
+// default path: from the full set to Seahorse Valley, 1e-5 (inside f32 resolution of all targets)
+static const zoomBenchmark::keyframe defaultPath[] = {
+    { -.75,               0.,                1.5,  256 },
+    { -.743643887037151,  .131825904205330,  1e-1, 512 },
+    { -.743643887037151,  .131825904205330,  1e-3, 1000 },
+    { -.743643887037151,  .131825904205330,  1e-5, 2000 },
+};
+
+const char *zoomBenchmark::usage()
+{
+    return "  --benchmark[=N]         replay the zoom path in N frames (default 600), uncapped present, then quit\n"
+           "  --benchmark-path=FILE   keyframes, one per line: centerX centerY scale iterations\n"
+           "  --benchmark-out=FILE    JSON report               (default mandel_benchmark.json)\n";
+}
+
+bool zoomBenchmark::parseArg(const char *arg)
+{
+    if(!strcmp(arg, "--benchmark"))                       frameCount = 600;
+    else if(!strncmp(arg, "--benchmark=", 12))            frameCount = std::max(2, atoi(arg + 12));
+    else if(!strncmp(arg, "--benchmark-path=", 17))       pathFile = arg + 17;
+    else if(!strncmp(arg, "--benchmark-out=", 16))        outFile  = arg + 16;
+    else return false;
+    if(!frameCount) frameCount = 600;       // path / out imply the benchmark
+    return true;
+}
+
+bool zoomBenchmark::loadPath(const char *file)
+{
+    FILE *f = fopen(file, "r");
+    if(!f) { printf("benchmark: can't open %s\n", file); return false; }
+    path.clear();
+    char line[256];
+    while(fgets(line, sizeof(line), f)) {
+        keyframe k;
+        if(line[0] != '#' && sscanf(line, "%lf %lf %lf %d", &k.cx, &k.cy, &k.scale, &k.iterations) == 4 && k.scale > 0) path.push_back(k);
+    }
+    fclose(f);
+    if(path.empty()) printf("benchmark: no keyframes in %s\n", file);
+    return !path.empty();
+}
+
+bool zoomBenchmark::start(const char *target)
+{
+    if(!pathFile || !loadPath(pathFile)) path.assign(std::begin(defaultPath), std::end(defaultPath));
+    targetName = target;
+    frame   = 0;
+    pixels  = 0;
+    frameMs.clear();
+    frameMs.reserve(frameCount);
+    running = true;
+    startTime = lastTime = std::chrono::steady_clock::now();
+    printf("benchmark: %d frames, %d keyframes\n", frameCount, int(path.size()));
+    return true;
+}
+
+zoomBenchmark::keyframe zoomBenchmark::currentView() const
+{
+    if(path.size() == 1) return path[0];
+
+    const double pos = double(frame) / double(frameCount - 1) * double(path.size() - 1);
+    const size_t k = std::min(size_t(pos), path.size() - 2);
+    const double t = pos - double(k);
+    const keyframe &a = path[k], &b = path[k + 1];
+
+    keyframe v;
+    v.scale      = a.scale * std::pow(b.scale / a.scale, t);
+    v.iterations = int32_t(std::lround(a.iterations + (b.iterations - a.iterations) * t));
+    // the center moves as much as the scale changed: a fixed point of the zoom, not a drift
+    const double w = a.scale != b.scale ? (a.scale - v.scale) / (a.scale - b.scale) : t;
+    v.cx = a.cx + (b.cx - a.cx) * w;
+    v.cy = a.cy + (b.cy - a.cy) * w;
+    return v;
+}
+
+bool zoomBenchmark::frameDone(uint32_t width, uint32_t height)
+{
+    if(!running) return false;
+    const auto now = std::chrono::steady_clock::now();
+    frameMs.push_back(float(std::chrono::duration<double, std::milli>(now - lastTime).count()));
+    lastTime = now;
+    pixels  += uint64_t(width) * height;
+
+    if(++frame < frameCount) return false;
+    running = false;
+    writeReport();
+    return true;
+}
+
+// JSON string literal: quotes, backslashes and control chars escaped (adapter names come from the driver)
+static std::string jsonString(const std::string &s)
+{
+    std::string out = "\"";
+    for(const char ch : s) {
+        const unsigned char c = (unsigned char) ch;
+        if(c == '"' || c == '\\') { out += '\\'; out += ch; }
+        else if(c < 0x20) { char esc[8]; snprintf(esc, sizeof(esc), "\\u%04x", c); out += esc; }
+        else out += ch;
+    }
+    return out + "\"";
+}
+
+bool zoomBenchmark::writeReport() const
+{
+    const double seconds = std::chrono::duration<double>(lastTime - startTime).count();
+    std::vector<float> sorted(frameMs);
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) { return sorted[std::min(sorted.size() - 1, size_t(p * double(sorted.size() - 1) + .5))]; };
+
+    std::string settings;
+    if(!adapter.empty()) settings += "  \"adapter\": " + jsonString(adapter) + ",\n";
+    for(const auto &kv : info) settings += "  " + jsonString(kv.first) + ": " + std::to_string(kv.second) + ",\n";
+
+    std::vector<char> buffer(settings.size() + 1024);    // escaped strings: no truncated report
+    char *json = buffer.data();
+    snprintf(json, buffer.size(),
+             "{\n"
+             "  \"target\": %s,\n"
+             "%s"
+             "  \"frames\": %d,\n"
+             "  \"keyframes\": %d,\n"
+             "  \"seconds\": %.4f,\n"
+             "  \"fps\": %.2f,\n"
+             "  \"mpixelsPerSecond\": %.2f,\n"
+             "  \"frameMs\": { \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }\n"
+             "}\n",
+             jsonString(targetName).c_str(), settings.c_str(), frame, int(path.size()), seconds, double(frame) / seconds, double(pixels) / seconds * 1e-6,
+             pct(0), pct(.5), pct(.9), pct(.95), pct(.99), pct(1));
+
+#if defined(__EMSCRIPTEN__)
+    printf("%s", json);      // no file system: report on the console
+    return true;
+#else
+    FILE *f = fopen(outFile, "w");
+    if(!f) { printf("benchmark: can't write %s\n%s", outFile, json); return false; }
+    fputs(json, f);
+    fclose(f);
+    printf("benchmark: %.2f frames/s, %.2f Mpixel/s -> %s\n", double(frame) / seconds, double(pixels) / seconds * 1e-6, outFile);
+    return true;
+#endif
+}
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+//  Copyright (c) 2025 Michele Morrone
+//  All rights reserved.
+//
+//  https://michelemorrone.eu - https://brutpitt.com
+//
+//  X: https://x.com/BrutPitt - GitHub: https://github.com/BrutPitt
+//
+//  direct mail: brutpitt(at)gmail.com - me(at)michelemorrone.eu
+//
+//  This software is distributed under the terms of the BSD 2-Clause license
+//------------------------------------------------------------------------------
+//  Scripted zoom path benchmark: same camera path, same frame count on every
+//  run (no mouse), to compare builds, drivers and targets
+//   - path: keyframes (center, scale, iterations), equally spaced in frames;
+//     between two keyframes scale is interpolated in log space and the center
+//     moves with the scale (zoom toward the next keyframe)
+//   - frame time: between two frameDone() (after Present, or after the wait of
+//     the submitted work when headless)
+//   - report: JSON with frames/s, Mpixel/s, frame time percentiles and adapter
+//  Options: --benchmark[=frames] --benchmark-path=file --benchmark-out=file.json
+//------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+
+class zoomBenchmark {
+public:
+    struct keyframe {
+        double  cx, cy;         // center (mTransp)
+        double  scale;          // half height of the view (mScaleY)
+        int32_t iterations;
+    };
+
+    // false: arg is not a benchmark option
+    bool parseArg(const char *arg);
+    bool isRequested() const { return frameCount > 0; }
+    bool isRunning()   const { return running; }
+
+    void setAdapter(const char *name) { adapter = name ? name : ""; }   // null / empty: no "adapter" in the report
+    void addInfo(const char *key, int value) { info.emplace_back(key, value); }    // settings of the run, in the report
+    bool start(const char *target);             // load path (default or --benchmark-path)
+    keyframe currentView() const;                // view of the frame to render
+    bool frameDone(uint32_t width, uint32_t height);   // true: path completed, report written
+
+    static const char *usage();
+
+private:
+    bool loadPath(const char *file);
+    bool writeReport() const;
+
+    int                   frameCount = 0, frame = 0;
+    bool                  running = false;
+    const char           *pathFile = nullptr;
+    const char           *outFile  = "mandel_benchmark.json";
+    std::string           adapter;
+    std::string           targetName;
+    std::vector<std::pair<std::string, int>> info;
+    std::vector<keyframe> path;
+    std::vector<float>    frameMs;
+    uint64_t              pixels = 0;
+    std::chrono::steady_clock::time_point startTime, lastTime;
+};